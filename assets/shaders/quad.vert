@@ -9,16 +9,25 @@ layout (location = 2) out flat int materialIdx;
 // Buffers
 layout (std430, binding = 0) buffer TransformSBO
 {
+#ifdef PACKED_TRANSFORMS
+  PackedTransform transforms[];
+#else
   Transform transforms[];
+#endif
 };
 
 uniform vec2 screenSize;
 uniform mat4 orthoProjection;
+uniform int transformOffset; // First Transform of the Draw, the Tile Layer draws ranges
 
 
 void main()
 {
-  Transform transform = transforms[gl_InstanceID];
+#ifdef PACKED_TRANSFORMS
+  Transform transform = unpack_transform(transforms[transformOffset + gl_InstanceID]);
+#else
+  Transform transform = transforms[transformOffset + gl_InstanceID];
+#endif
 
   // Generating Vertices on the GPU
   // mostly because we have a 2D Engine
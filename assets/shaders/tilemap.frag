@@ -0,0 +1,42 @@
+
+// Input
+layout (location = 0) in vec2 worldPosIn;
+
+// Output
+layout (location = 0) out vec4 fragColor;
+
+// Bindings, binding = 0 binds to GL_TEXTURE0, binding = 2 binds to GL_TEXTURE2
+layout (binding = 0) uniform sampler2D textureAtlas;
+layout (binding = 2) uniform usampler2D tileMap; // One Tile Type per Texel, 0 is empty
+
+// Input Buffers
+layout(std430, binding = 1) buffer Materials
+{
+  Material materials[];
+};
+
+uniform int tileSize;
+uniform int tileMaterialIdx;
+uniform ivec2 tileAtlasOffsets[MAX_TILE_TYPES]; // Tile Type n uses tileAtlasOffsets[n - 1]
+
+void main()
+{
+  ivec2 worldPixel = ivec2(floor(worldPosIn));
+  ivec2 tilePos = worldPixel / tileSize;
+  uint tileType = texelFetch(tileMap, tilePos, 0).r;
+
+  if(tileType == 0u)
+  {
+    discard;
+  }
+
+  ivec2 atlasPos = tileAtlasOffsets[tileType - 1u] + worldPixel - tilePos * tileSize;
+  vec4 textureColor = texelFetch(textureAtlas, atlasPos, 0);
+
+  if(textureColor.a == 0.0)
+  {
+    discard;
+  }
+
+  fragColor = textureColor * materials[tileMaterialIdx].color;
+}
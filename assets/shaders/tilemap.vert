@@ -0,0 +1,28 @@
+
+// Input
+
+// Output
+layout (location = 0) out vec2 worldPosOut;
+
+uniform mat4 orthoProjection;
+uniform vec2 tileMapPos; // Visible part of the Tile Map, in world units
+uniform vec2 tileMapSize;
+uniform float tileLayer;
+
+void main()
+{
+  // One Quad over all visible Tiles, tilemap.frag looks up the Tile of each Pixel
+  vec2 vertices[6] =
+  {
+    tileMapPos,                                   // Top Left
+    vec2(tileMapPos + vec2(0.0, tileMapSize.y)),  // Bottom Left
+    vec2(tileMapPos + vec2(tileMapSize.x, 0.0)),  // Top Right
+    vec2(tileMapPos + vec2(tileMapSize.x, 0.0)),  // Top Right
+    vec2(tileMapPos + vec2(0.0, tileMapSize.y)),  // Bottom Left
+    tileMapPos + tileMapSize                      // Bottom Right
+  };
+
+  vec2 vertexPos = vertices[gl_VertexID];
+  gl_Position = orthoProjection * vec4(vertexPos, tileLayer, 1.0);
+  worldPosOut = vertexPos;
+}
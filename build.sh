@@ -1,6 +1,8 @@
 #!/bin/bash
 
 defines="-DENGINE"
+# Uncomment for 16 Byte Transforms on the GPU instead of 48, see shader_header.h
+# defines="$defines -DPACKED_TRANSFORMS"
 warnings="-Wno-writable-strings -Wno-format-security -Wno-deprecated-declarations -Wno-switch"
 includes="-Ithird_party -Ithird_party/Include"
 
@@ -8,12 +10,24 @@ timestamp=$(date +%s)
 
 if [[ "$(uname)" == "Linux" ]]; then
     echo "Running on Linux"
-    libs="-lX11 -lGL -lfreetype"
+    # The Game rasterizes Glyphs on demand, so it links FreeType as well, see font.h
+    fontLibs="-lfreetype"
+    libs="-lX11 -lGL -pthread $fontLibs"
+    headlessLibs="-pthread $fontLibs"
     outputFile=schnitzel
+    packedOutputFile=schnitzel_packed
+    headlessFile=schnitzel_headless
+    fontBakerFile=font_baker
+    assetBakerFile=asset_baker
+
+    # Packs the Sprites into the Texture Atlas and writes src/sprite_ids.h, 
+    # so it runs before anything else is compiled
+    clang++ $includes -g src/asset_baker.cpp -o$assetBakerFile $warnings $defines
+    ./$assetBakerFile
 
     # fPIC position independent code https://stackoverflow.com/questions/5311515/gcc-fpic-option
     rm -f game_* # Remove old game_* files
-    clang++ -g "src/game.cpp" -shared -fPIC -o game_$timestamp.so $warnings $defines
+    clang++ $includes -g "src/game.cpp" -shared -fPIC -o game_$timestamp.so $fontLibs $warnings $defines
     mv game_$timestamp.so game.so
 
 elif [[ "$(uname)" == "Darwin" ]]; then
@@ -21,13 +35,33 @@ elif [[ "$(uname)" == "Darwin" ]]; then
 
 else
     echo "Running on Windows"
-    libs="-luser32 -lopengl32 -lgdi32 -lole32 -Lthird_party/lib -lfreetype.lib"
+    fontLibs="-Lthird_party/lib -lfreetype.lib"
+    libs="-luser32 -lopengl32 -lgdi32 -lole32 $fontLibs"
+    headlessLibs="$fontLibs"
     outputFile=schnitzel.exe
+    packedOutputFile=schnitzel_packed.exe
+    headlessFile=schnitzel_headless.exe
+    fontBakerFile=font_baker.exe
+    assetBakerFile=asset_baker.exe
+
+    clang++ $includes -g src/asset_baker.cpp -o$assetBakerFile $warnings $defines
+    ./$assetBakerFile
 
     rm -f game_* # Remove old game_* files
-    clang++ -g "src/game.cpp" -shared -o game_$timestamp.dll $warnings $defines
+    clang++ $includes -g "src/game.cpp" -shared -o game_$timestamp.dll $fontLibs $warnings $defines
     mv game_$timestamp.dll game.dll
 fi
 
 
-clang++ $includes -g src/main.cpp -o$outputFile $libs $warnings $defines
\ No newline at end of file
+# Bakes the Font Atlas, so the Game doesn't have to rasterize with FreeType on startup
+clang++ $includes -g src/font_baker.cpp -o$fontBakerFile $fontLibs $warnings $defines
+./$fontBakerFile assets/fonts/AtariClassic-gry3.ttf 8 assets/fonts/AtariClassic-gry3.font
+
+clang++ $includes -g src/main.cpp -o$outputFile $libs $warnings $defines
+
+# Only built, so the PACKED_TRANSFORMS Path keeps compiling,
+# its Frames are checked with schnitzel_headless --check-packing
+clang++ $includes -g src/main.cpp -o$packedOutputFile $libs $warnings $defines -DPACKED_TRANSFORMS
+
+# Headless Simulation Runner, no Window, OpenGL or Audio, used to benchmark the Simulation
+clang++ $includes -g -O2 src/headless_main.cpp -o$headlessFile $headlessLibs $warnings $defines
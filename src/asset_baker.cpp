@@ -0,0 +1,301 @@
+// #############################################################################
+//                           Asset Baker
+// #############################################################################
+// Packs the Sprite images listed in assets/sprites/sprites.txt into the Texture
+// Atlas and writes the Sprite Table and the SpriteID enum for them, so adding Art
+// doesn't mean editing C++ anymore, see get_sprite()
+//
+// Usage: asset_baker, run from the root of the Project, build.sh does that
+#include "assets.h"
+
+// To Load the Sprite images
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <stdlib.h>
+
+// #############################################################################
+//                           Asset Baker Constants
+// #############################################################################
+const char* SPRITE_MANIFEST_PATH = "assets/sprites/sprites.txt";
+const char* SPRITE_DIRECTORY = "assets/sprites/";
+const char* SPRITE_IDS_PATH = "src/sprite_ids.h";
+
+constexpr int MAX_BAKED_SPRITES = 1024;
+constexpr int SPRITE_ATLAS_WIDTH = 1024;
+constexpr int SPRITE_PADDING = 1;
+
+// #############################################################################
+//                           Asset Baker Structs
+// #############################################################################
+struct BakedSprite
+{
+  char name[64];
+  char imagePath[256];
+  int frameCount;
+
+  int width;
+  int height;
+  unsigned char* pixels;
+
+  IVec2 atlasOffset;
+};
+
+// #############################################################################
+//                           Asset Baker Functions
+// #############################################################################
+// Returns the number of Sprites, -1 on Error
+int parse_sprite_manifest(char* manifest, BakedSprite* bakedSprites)
+{
+  int spriteCount = 0;
+  int lineNumber = 0;
+
+  char* line = manifest;
+  while(line && *line)
+  {
+    lineNumber++;
+    char* nextLine = strchr(line, '\n');
+    if(nextLine)
+    {
+      *nextLine++ = 0;
+    }
+
+    char* comment = strchr(line, '#');
+    if(comment)
+    {
+      *comment = 0;
+    }
+
+    char name[64] = {};
+    char image[128] = {};
+    int frameCount = 0;
+    int fieldCount = sscanf(line, "%63s %127s %d", name, image, &frameCount);
+    if(fieldCount > 0)
+    {
+      if(fieldCount != 3 || frameCount < 1 || strncmp(name, "SPRITE_", 7))
+      {
+        SM_ERROR("%s:%d: Expected <SPRITE_NAME> <image> <frameCount>",
+                 SPRITE_MANIFEST_PATH, lineNumber);
+        return -1;
+      }
+
+      if(spriteCount == MAX_BAKED_SPRITES)
+      {
+        SM_ERROR("Too many Sprites, max is %d", MAX_BAKED_SPRITES);
+        return -1;
+      }
+
+      BakedSprite& bakedSprite = bakedSprites[spriteCount++];
+      strcpy(bakedSprite.name, name);
+      snprintf(bakedSprite.imagePath, sizeof(bakedSprite.imagePath), "%s%s",
+               SPRITE_DIRECTORY, image);
+      bakedSprite.frameCount = frameCount;
+    }
+
+    line = nextLine;
+  }
+
+  return spriteCount;
+}
+
+// Shelf packing, the tallest Sprites first, returns the Height of the Atlas
+int pack_sprites(BakedSprite* bakedSprites, int spriteCount)
+{
+  int order[MAX_BAKED_SPRITES];
+  for(int i = 0; i < spriteCount; i++)
+  {
+    order[i] = i;
+  }
+
+  // Insertion sort, stable, so the Atlas only changes where the Sprites do
+  for(int i = 1; i < spriteCount; i++)
+  {
+    int spriteIdx = order[i];
+    int j = i - 1;
+    for(; j >= 0 && bakedSprites[order[j]].height < bakedSprites[spriteIdx].height; j--)
+    {
+      order[j + 1] = order[j];
+    }
+    order[j + 1] = spriteIdx;
+  }
+
+  IVec2 cursor = {};
+  int shelfHeight = 0;
+  for(int i = 0; i < spriteCount; i++)
+  {
+    BakedSprite& bakedSprite = bakedSprites[order[i]];
+    if(cursor.x + bakedSprite.width > SPRITE_ATLAS_WIDTH)
+    {
+      cursor.x = 0;
+      cursor.y += shelfHeight + SPRITE_PADDING;
+      shelfHeight = 0;
+    }
+
+    bakedSprite.atlasOffset = cursor;
+    cursor.x += bakedSprite.width + SPRITE_PADDING;
+    shelfHeight = max(shelfHeight, bakedSprite.height);
+  }
+
+  // Power of two, like the Atlas used to be
+  int usedHeight = cursor.y + shelfHeight;
+  int atlasHeight = 1;
+  while(atlasHeight < usedHeight)
+  {
+    atlasHeight *= 2;
+  }
+
+  return atlasHeight;
+}
+
+// Uncompressed 32 Bit TGA, stb_image reads it and it needs no compression Library
+void write_tga(const char* filePath, unsigned char* pixels, int width, int height)
+{
+  int headerSize = 18;
+  int fileSize = headerSize + width * height * 4;
+  unsigned char* buffer = (unsigned char*)calloc(1, fileSize);
+
+  buffer[2] = 2; // Uncompressed True Color
+  buffer[12] = width & 0xFF;
+  buffer[13] = (width >> 8) & 0xFF;
+  buffer[14] = height & 0xFF;
+  buffer[15] = (height >> 8) & 0xFF;
+  buffer[16] = 32;
+  buffer[17] = 8 | 0x20; // 8 Alpha Bits, Origin at the top left
+
+  // TGA stores BGRA
+  unsigned char* dst = buffer + headerSize;
+  for(int i = 0; i < width * height; i++)
+  {
+    dst[i * 4 + 0] = pixels[i * 4 + 2];
+    dst[i * 4 + 1] = pixels[i * 4 + 1];
+    dst[i * 4 + 2] = pixels[i * 4 + 0];
+    dst[i * 4 + 3] = pixels[i * 4 + 3];
+  }
+
+  write_file(filePath, (char*)buffer, fileSize);
+  free(buffer);
+}
+
+void write_sprite_ids(BakedSprite* bakedSprites, int spriteCount)
+{
+  int bufferSize = 256 + spriteCount * 80;
+  char* buffer = (char*)malloc(bufferSize);
+  int length = snprintf(buffer, bufferSize,
+                        "#pragma once\n\n"
+                        "// Generated by asset_baker.cpp from %s, don't edit\n"
+                        "enum SpriteID\n"
+                        "{\n", SPRITE_MANIFEST_PATH);
+
+  for(int i = 0; i < spriteCount; i++)
+  {
+    length += snprintf(buffer + length, bufferSize - length,
+                       "  %s,\n", bakedSprites[i].name);
+  }
+
+  length += snprintf(buffer + length, bufferSize - length,
+                     "\n"
+                     "  SPRITE_COUNT\n"
+                     "};\n");
+
+  write_file(SPRITE_IDS_PATH, buffer, length);
+  free(buffer);
+}
+
+int main(int argc, char** argv)
+{
+  // Too big for the Stack
+  BakedSprite* bakedSprites = (BakedSprite*)calloc(MAX_BAKED_SPRITES, sizeof(BakedSprite));
+
+  long manifestSize = get_file_size(SPRITE_MANIFEST_PATH);
+  char* manifest = (char*)malloc(manifestSize + 1);
+  int fileSize = 0;
+  if(!manifestSize || !read_file(SPRITE_MANIFEST_PATH, &fileSize, manifest))
+  {
+    return 1;
+  }
+
+  int spriteCount = parse_sprite_manifest(manifest, bakedSprites);
+  if(spriteCount <= 0)
+  {
+    SM_ERROR("No Sprites in %s", SPRITE_MANIFEST_PATH);
+    return 1;
+  }
+
+  for(int i = 0; i < spriteCount; i++)
+  {
+    BakedSprite& bakedSprite = bakedSprites[i];
+
+    int channels = 0;
+    bakedSprite.pixels = stbi_load(bakedSprite.imagePath, &bakedSprite.width,
+                                   &bakedSprite.height, &channels, 4);
+    if(!bakedSprite.pixels)
+    {
+      SM_ERROR("Failed to load Sprite %s: %s", bakedSprite.name, bakedSprite.imagePath);
+      return 1;
+    }
+
+    if(bakedSprite.width % bakedSprite.frameCount ||
+       bakedSprite.width > SPRITE_ATLAS_WIDTH)
+    {
+      SM_ERROR("Sprite %s is %d wide, doesn't fit the Atlas or split into %d frames",
+               bakedSprite.name, bakedSprite.width, bakedSprite.frameCount);
+      return 1;
+    }
+  }
+
+  int atlasHeight = pack_sprites(bakedSprites, spriteCount);
+  if(atlasHeight > SPRITE_ATLAS_WIDTH * 4)
+  {
+    SM_ERROR("Sprites don't fit the Atlas, height would be %d", atlasHeight);
+    return 1;
+  }
+
+  // Texture Atlas
+  {
+    unsigned char* atlas = (unsigned char*)calloc(SPRITE_ATLAS_WIDTH * atlasHeight, 4);
+    for(int i = 0; i < spriteCount; i++)
+    {
+      BakedSprite& bakedSprite = bakedSprites[i];
+      for(int y = 0; y < bakedSprite.height; y++)
+      {
+        int atlasIdx = (bakedSprite.atlasOffset.y + y) * SPRITE_ATLAS_WIDTH +
+                       bakedSprite.atlasOffset.x;
+        memcpy(&atlas[atlasIdx * 4], &bakedSprite.pixels[y * bakedSprite.width * 4],
+               bakedSprite.width * 4);
+      }
+    }
+
+    write_tga(TEXTURE_PATH, atlas, SPRITE_ATLAS_WIDTH, atlasHeight);
+    free(atlas);
+  }
+
+  // Sprite Table, indexed by SpriteID
+  {
+    int tableSize = sizeof(SpriteTableHeader) + sizeof(Sprite) * spriteCount;
+    char* table = (char*)calloc(1, tableSize);
+
+    SpriteTableHeader* header = (SpriteTableHeader*)table;
+    header->magic = SPRITE_TABLE_MAGIC;
+    header->version = SPRITE_TABLE_VERSION;
+    header->spriteCount = spriteCount;
+
+    Sprite* tableSprites = (Sprite*)(table + sizeof(SpriteTableHeader));
+    for(int i = 0; i < spriteCount; i++)
+    {
+      BakedSprite& bakedSprite = bakedSprites[i];
+      tableSprites[i].atlasOffset = bakedSprite.atlasOffset;
+      tableSprites[i].size = {bakedSprite.width / bakedSprite.frameCount, bakedSprite.height};
+      tableSprites[i].frameCount = bakedSprite.frameCount;
+    }
+
+    write_file(SPRITE_TABLE_PATH, table, tableSize);
+    free(table);
+  }
+
+  write_sprite_ids(bakedSprites, spriteCount);
+
+  SM_TRACE("Baked %d Sprites into %s, %dx%d",
+           spriteCount, TEXTURE_PATH, SPRITE_ATLAS_WIDTH, atlasHeight);
+
+  return 0;
+}
@@ -2,28 +2,22 @@
 
 #include "schnitzel_lib.h"
 
+// Generated by asset_baker.cpp from assets/sprites/sprites.txt
+#include "sprite_ids.h"
+
 // #############################################################################
 //                           Assets Constants
 // #############################################################################
+// Both written by asset_baker.cpp, the Sprite Table holds the Atlas Offsets
+const char* TEXTURE_PATH = "assets/textures/TEXTURE_ATLAS.tga";
+const char* SPRITE_TABLE_PATH = "assets/textures/SPRITE_TABLE.bin";
+
+constexpr int SPRITE_TABLE_MAGIC = 0x54525053; // "SPRT"
+constexpr int SPRITE_TABLE_VERSION = 1;
 
 // #############################################################################
 //                           Assets Structs
 // #############################################################################
-enum SpriteID
-{
-  SPRITE_WHITE,
-  SPRITE_DICE,
-  SPRITE_CELESTE,
-  SPRITE_CELESTE_RUN,
-  SPRITE_CELESTE_JUMP,
-  SPRITE_SOLID_01,
-  SPRITE_SOLID_02,  
-  SPRITE_BUTTON_PLAY,
-  SPRITE_BUTTON_SAVE,
-
-  SPRITE_COUNT
-};
-
 struct Sprite
 {
   IVec2 atlasOffset;
@@ -31,80 +25,55 @@ struct Sprite
   int frameCount = 1;
 };
 
+// The File starts with this, followed by spriteCount Sprites,
+// in the order of the SpriteID enum
+struct SpriteTableHeader
+{
+  int magic;
+  int version;
+  int spriteCount;
+};
+
+// #############################################################################
+//                           Assets Globals
+// #############################################################################
+static Sprite sprites[SPRITE_COUNT];
+
 // #############################################################################
 //                           Assets Functions
 // #############################################################################
-Sprite get_sprite(SpriteID spriteID)
+// Called whenever the Game is (re)loaded, the Table has to match sprite_ids.h,
+// both are written in the same bake
+bool init_sprites()
 {
-  Sprite sprite = {};
-  sprite.frameCount = 1;
-
-  switch(spriteID)
+  char buffer[sizeof(SpriteTableHeader) + sizeof(Sprite) * SPRITE_COUNT + 1];
+  long expectedSize = sizeof(SpriteTableHeader) + sizeof(Sprite) * SPRITE_COUNT;
+  if(get_file_size(SPRITE_TABLE_PATH) != expectedSize)
   {
-    case SPRITE_WHITE:
-    {
-      sprite.atlasOffset = {0, 0};
-      sprite.size = {1, 1};
-      break;
-    }
-
-    case SPRITE_DICE:
-    {
-      sprite.atlasOffset = {16, 0};
-      sprite.size = {16, 16};
-      break;
-    }
-
-    case SPRITE_CELESTE:
-    {
-      sprite.atlasOffset = {112, 0};
-      sprite.size = {17, 20};
-      break;
-    }
-
-    case SPRITE_CELESTE_RUN:
-    {
-      sprite.atlasOffset = {128, 0};
-      sprite.size = {17, 20};
-      sprite.frameCount = 12;
-      break;
-    }
-
-    case SPRITE_CELESTE_JUMP:
-    {
-      sprite.atlasOffset = {229, 0};
-      sprite.size = {17, 20};
-      break;
-    }
+    SM_ASSERT(false, "Sprite Table %s doesn't match sprite_ids.h, run the asset_baker",
+              SPRITE_TABLE_PATH);
+    return false;
+  }
 
-    case SPRITE_SOLID_01:
-    {
-      sprite.atlasOffset = {0, 16};
-      sprite.size = {28, 18};
-      break;
-    }
+  int fileSize = 0;
+  read_file(SPRITE_TABLE_PATH, &fileSize, buffer);
 
-    case SPRITE_SOLID_02:
-    {
-      sprite.atlasOffset = {32, 16};
-      sprite.size = {16, 13};
-      break;
-    }
+  SpriteTableHeader* header = (SpriteTableHeader*)buffer;
+  if(fileSize != expectedSize ||
+     header->magic != SPRITE_TABLE_MAGIC ||
+     header->version != SPRITE_TABLE_VERSION ||
+     header->spriteCount != SPRITE_COUNT)
+  {
+    SM_ASSERT(false, "Invalid Sprite Table %s", SPRITE_TABLE_PATH);
+    return false;
+  }
 
-    case SPRITE_BUTTON_PLAY:
-    {
-      sprite.atlasOffset = {80, 0};
-      sprite.size = {32, 16};
-      break;
-    }
+  memcpy(sprites, buffer + sizeof(SpriteTableHeader), sizeof(Sprite) * SPRITE_COUNT);
 
-    case SPRITE_BUTTON_SAVE:
-    {
-      sprite.atlasOffset = {80, 16};
-      sprite.size = {32, 16};
-      break;
-    }
-  }
+  return true;
+}
 
-  return sprite;
+Sprite get_sprite(SpriteID spriteID)
+{
+  return sprites[spriteID];
 }
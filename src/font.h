@@ -0,0 +1,411 @@
+#pragma once
+
+#include "schnitzel_lib.h"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+// #############################################################################
+//                           Font Constants
+// #############################################################################
+constexpr int FONT_ATLAS_SIZE = 512;
+constexpr int GLYPH_PADDING = 2;
+
+// Glyphs are rasterized when a Text first uses them, the Atlas is split into
+// Shelves of one line each, the least recently used Shelf is evicted when full
+constexpr int MAX_GLYPH_SHELVES = 64;
+constexpr int MAX_CACHED_GLYPHS = 2048;
+constexpr int GLYPH_HASH_SLOTS = 4096;
+
+constexpr uint32_t UTF8_REPLACEMENT_CHARACTER = 0xFFFD;
+
+const char* FONT_PATH = "assets/fonts/AtariClassic-gry3.ttf";
+const char* BAKED_FONT_PATH = "assets/fonts/AtariClassic-gry3.font"; // Written by build.sh
+constexpr int FONT_SIZE = 8;
+
+// Baked Fonts are written by font_baker.cpp, see BakedFontHeader
+constexpr int BAKED_FONT_MAGIC = 0x544e4f46; // "FONT"
+constexpr int BAKED_FONT_VERSION = 2;
+
+// #############################################################################
+//                           Font Structs
+// #############################################################################
+struct Glyph
+{
+  Vec2 offset;
+  Vec2 advance;
+  IVec2 textureCoords;
+  IVec2 size;
+};
+
+struct CachedGlyph
+{
+  uint32_t codepoint;
+  int shelfIdx;
+  Glyph glyph;
+};
+
+struct GlyphShelf
+{
+  int posY;
+  int usedWidth;
+  int lastUsedFrame;
+};
+
+struct FontCache
+{
+  // Opened on the first Glyph that isn't cached yet, the Game rasterizes 
+  // through the same Face as the Renderer
+  char fontPath[256];
+  int fontSize;
+  FT_Face fontFace;
+  int fontHeight;
+  int glyphHeight; // Of the tallest Glyph, the Shelves are this high plus Padding
+
+  // Advanced every frame, Shelves used in the current frame are never evicted
+  int frame;
+  // Increased on every eviction, Glyphs laid out before point at stale Atlas space
+  int generation;
+  // Increased for every Glyph that didn't fit into the Atlas, they are not drawn
+  int droppedGlyphCount;
+
+  Array<CachedGlyph, MAX_CACHED_GLYPHS> glyphs;
+  int glyphSlots[GLYPH_HASH_SLOTS]; // glyphIdx + 1, 0 is an empty Slot
+  Array<GlyphShelf, MAX_GLYPH_SHELVES> shelves;
+
+  // Part of the Atlas that changed since the last upload, size 0 if none
+  IRect dirtyRect;
+  unsigned char atlas[FONT_ATLAS_SIZE * FONT_ATLAS_SIZE];
+};
+
+// The File starts with this, followed by glyphCount CachedGlyphs, 
+// shelfCount GlyphShelves and the Atlas, atlasSize * atlasSize Bytes
+struct BakedFontHeader
+{
+  int magic;
+  int version;
+  uint64_t ttfHash; // hash_bytes() of the TTF File
+  int fontSize;
+  int fontHeight;
+  int glyphHeight;
+  int atlasSize;
+  int glyphCount;
+  int shelfCount;
+};
+
+// #############################################################################
+//                           Font Functions
+// #############################################################################
+// Returns 0 at the end of the Text, invalid Bytes decode to U+FFFD
+uint32_t decode_utf8(char** text)
+{
+  unsigned char* bytes = (unsigned char*)*text;
+  if(!bytes[0])
+  {
+    return 0;
+  }
+
+  int byteCount = 1;
+  uint32_t codepoint = bytes[0];
+  if(bytes[0] >= 0xF0)
+  {
+    byteCount = 4;
+    codepoint = bytes[0] & 0x07;
+  }
+  else if(bytes[0] >= 0xE0)
+  {
+    byteCount = 3;
+    codepoint = bytes[0] & 0x0F;
+  }
+  else if(bytes[0] >= 0xC0)
+  {
+    byteCount = 2;
+    codepoint = bytes[0] & 0x1F;
+  }
+  else if(bytes[0] >= 0x80)
+  {
+    // Continuation Byte without a leading one
+    *text += 1;
+    return UTF8_REPLACEMENT_CHARACTER;
+  }
+
+  for(int byteIdx = 1; byteIdx < byteCount; byteIdx++)
+  {
+    if((bytes[byteIdx] & 0xC0) != 0x80)
+    {
+      // Truncated sequence, continue at the Byte that broke it
+      *text += byteIdx;
+      return UTF8_REPLACEMENT_CHARACTER;
+    }
+    codepoint = (codepoint << 6) | (bytes[byteIdx] & 0x3F);
+  }
+
+  *text += byteCount;
+  return codepoint;
+}
+
+int get_glyph_slot(uint32_t codepoint)
+{
+  return hash_bytes((char*)&codepoint, sizeof(uint32_t)) & (GLYPH_HASH_SLOTS - 1);
+}
+
+// There are no tombstones, removing Glyphs rebuilds the whole Table
+void rebuild_glyph_slots(FontCache* fontCache)
+{
+  memset(fontCache->glyphSlots, 0, sizeof(fontCache->glyphSlots));
+  for(int glyphIdx = 0; glyphIdx < fontCache->glyphs.count; glyphIdx++)
+  {
+    int slotIdx = get_glyph_slot(fontCache->glyphs[glyphIdx].codepoint);
+    while(fontCache->glyphSlots[slotIdx])
+    {
+      slotIdx = (slotIdx + 1) & (GLYPH_HASH_SLOTS - 1);
+    }
+    fontCache->glyphSlots[slotIdx] = glyphIdx + 1;
+  }
+}
+
+bool load_font_face(FontCache* fontCache)
+{
+  if(!fontCache->fontPath[0])
+  {
+    return false;
+  }
+
+  // Only initialized once, the Faces of all Fonts would share it
+  static FT_Library fontLibrary;
+  if(!fontLibrary && FT_Init_FreeType(&fontLibrary))
+  {
+    SM_ASSERT(false, "Failed to initialize FreeType");
+    return false;
+  }
+
+  FT_Face fontFace;
+  if(FT_New_Face(fontLibrary, fontCache->fontPath, 0, &fontFace))
+  {
+    SM_ASSERT(false, "Failed to load Font: %s", fontCache->fontPath);
+    fontCache->fontPath[0] = 0;
+    return false;
+  }
+  FT_Set_Pixel_Sizes(fontFace, 0, fontCache->fontSize);
+
+  fontCache->fontFace = fontFace;
+  fontCache->fontHeight = 
+    (fontFace->size->metrics.ascender - fontFace->size->metrics.descender) >> 6;
+
+  // Accented Capitals and some CJK Glyphs reach past the Ascender or Descender
+  fontCache->glyphHeight = fontCache->fontHeight;
+  if(FT_IS_SCALABLE(fontFace))
+  {
+    FT_Pos bboxHeight = FT_MulFix(fontFace->bbox.yMax - fontFace->bbox.yMin, 
+                                  fontFace->size->metrics.y_scale);
+    fontCache->glyphHeight = max(fontCache->glyphHeight, (int)((bboxHeight + 63) >> 6));
+  }
+
+  return true;
+}
+
+void mark_dirty(FontCache* fontCache, IRect rect)
+{
+  IRect& dirtyRect = fontCache->dirtyRect;
+  if(!dirtyRect.size.x || !dirtyRect.size.y)
+  {
+    dirtyRect = rect;
+    return;
+  }
+
+  int minX = min(dirtyRect.pos.x, rect.pos.x);
+  int minY = min(dirtyRect.pos.y, rect.pos.y);
+  int maxX = max(dirtyRect.pos.x + dirtyRect.size.x, rect.pos.x + rect.size.x);
+  int maxY = max(dirtyRect.pos.y + dirtyRect.size.y, rect.pos.y + rect.size.y);
+  dirtyRect = {minX, minY, maxX - minX, maxY - minY};
+}
+
+// Drops every Glyph of the least recently used Shelf, returns -1 if all
+// Shelves were used in the current frame
+int evict_glyph_shelf(FontCache* fontCache)
+{
+  int shelfIdx = -1;
+  for(int idx = 0; idx < fontCache->shelves.count; idx++)
+  {
+    GlyphShelf& shelf = fontCache->shelves[idx];
+    if(shelf.lastUsedFrame != fontCache->frame &&
+       (shelfIdx < 0 || shelf.lastUsedFrame < fontCache->shelves[shelfIdx].lastUsedFrame))
+    {
+      shelfIdx = idx;
+    }
+  }
+
+  if(shelfIdx < 0)
+  {
+    return -1;
+  }
+
+  for(int glyphIdx = 0; glyphIdx < fontCache->glyphs.count;)
+  {
+    if(fontCache->glyphs[glyphIdx].shelfIdx == shelfIdx)
+    {
+      fontCache->glyphs.remove_idx_and_swap(glyphIdx);
+      continue;
+    }
+    glyphIdx++;
+  }
+  rebuild_glyph_slots(fontCache);
+
+  GlyphShelf& shelf = fontCache->shelves[shelfIdx];
+  int shelfHeight = min(fontCache->glyphHeight + GLYPH_PADDING, FONT_ATLAS_SIZE - shelf.posY);
+  memset(&fontCache->atlas[shelf.posY * FONT_ATLAS_SIZE], 0, shelfHeight * FONT_ATLAS_SIZE);
+  mark_dirty(fontCache, {0, shelf.posY, FONT_ATLAS_SIZE, shelfHeight});
+  shelf.usedWidth = GLYPH_PADDING;
+
+  fontCache->generation++;
+
+  return shelfIdx;
+}
+
+// Returns the Shelf with space for width Pixels, -1 if there is none, even after evicting
+int find_glyph_shelf(FontCache* fontCache, int width)
+{
+  if(!fontCache->glyphs.is_full())
+  {
+    for(int shelfIdx = 0; shelfIdx < fontCache->shelves.count; shelfIdx++)
+    {
+      if(fontCache->shelves[shelfIdx].usedWidth + width + GLYPH_PADDING <= FONT_ATLAS_SIZE)
+      {
+        return shelfIdx;
+      }
+    }
+
+    int shelfHeight = fontCache->glyphHeight + GLYPH_PADDING;
+    int posY = fontCache->shelves.count * shelfHeight;
+    if(!fontCache->shelves.is_full() && posY + shelfHeight <= FONT_ATLAS_SIZE)
+    {
+      GlyphShelf shelf = {};
+      shelf.posY = posY;
+      shelf.usedWidth = GLYPH_PADDING;
+      return fontCache->shelves.add(shelf);
+    }
+  }
+
+  return evict_glyph_shelf(fontCache);
+}
+
+// Rasterizes the Glyph on the first use, shelfMask gets the Bit of the Shelf it lives in
+Glyph get_glyph(FontCache* fontCache, uint32_t codepoint, uint64_t* shelfMask = nullptr)
+{
+  int slotIdx = get_glyph_slot(codepoint);
+
+  // Linear probing, the table is never more than half full
+  while(fontCache->glyphSlots[slotIdx])
+  {
+    CachedGlyph& cachedGlyph = fontCache->glyphs[fontCache->glyphSlots[slotIdx] - 1];
+    if(cachedGlyph.codepoint == codepoint)
+    {
+      // Glyphs FreeType failed on are cached empty, without a Shelf
+      if(cachedGlyph.shelfIdx >= 0)
+      {
+        fontCache->shelves[cachedGlyph.shelfIdx].lastUsedFrame = fontCache->frame;
+        if(shelfMask)
+        {
+          *shelfMask |= 1ull << cachedGlyph.shelfIdx;
+        }
+      }
+      return cachedGlyph.glyph;
+    }
+
+    slotIdx = (slotIdx + 1) & (GLYPH_HASH_SLOTS - 1);
+  }
+
+  // No Font loaded, the headless Runner for example
+  if(!fontCache->fontFace && !load_font_face(fontCache))
+  {
+    return {};
+  }
+
+  FT_Face fontFace = fontCache->fontFace;
+  FT_UInt glyphIndex = FT_Get_Char_Index(fontFace, codepoint);
+  if(FT_Load_Glyph(fontFace, glyphIndex, FT_LOAD_DEFAULT) ||
+     FT_Render_Glyph(fontFace->glyph, FT_RENDER_MODE_NORMAL))
+  {
+    // fontFace->glyph still holds the last Glyph, so nothing of it is used
+    SM_WARN("Failed to rasterize Glyph %u, it is not drawn", codepoint);
+    if(!fontCache->glyphs.is_full())
+    {
+      CachedGlyph cachedGlyph = {};
+      cachedGlyph.codepoint = codepoint;
+      cachedGlyph.shelfIdx = -1;
+      fontCache->glyphSlots[slotIdx] = fontCache->glyphs.add(cachedGlyph) + 1;
+    }
+    return {};
+  }
+  FT_Bitmap bitmap = fontFace->glyph->bitmap;
+
+  Glyph glyph = {};
+  glyph.advance =
+  {
+    (float)(fontFace->glyph->advance.x >> 6),
+    (float)(fontFace->glyph->advance.y >> 6)
+  };
+  glyph.offset =
+  {
+    (float)fontFace->glyph->bitmap_left,
+    (float)fontFace->glyph->bitmap_top,
+  };
+
+  int width = min((int)bitmap.width, FONT_ATLAS_SIZE - 2 * GLYPH_PADDING);
+  int shelfIdx = find_glyph_shelf(fontCache, width);
+  if(shelfIdx < 0)
+  {
+    SM_WARN("Font Atlas is full, Glyph %u is not drawn this frame", codepoint);
+    fontCache->droppedGlyphCount++;
+    return glyph;
+  }
+
+  // Evicting rebuilt the Hash Table
+  slotIdx = get_glyph_slot(codepoint);
+  while(fontCache->glyphSlots[slotIdx])
+  {
+    slotIdx = (slotIdx + 1) & (GLYPH_HASH_SLOTS - 1);
+  }
+
+  GlyphShelf& shelf = fontCache->shelves[shelfIdx];
+  int height = min((int)bitmap.rows, fontCache->glyphHeight);
+  if(height < (int)bitmap.rows)
+  {
+    SM_WARN("Glyph %u is %d high, cut to %d", codepoint, bitmap.rows, height);
+  }
+  for(int y = 0; y < height; y++)
+  {
+    memcpy(&fontCache->atlas[(shelf.posY + y) * FONT_ATLAS_SIZE + shelf.usedWidth],
+           &bitmap.buffer[y * bitmap.pitch], width);
+  }
+
+  glyph.textureCoords = {shelf.usedWidth, shelf.posY};
+  glyph.size = {width, height};
+  mark_dirty(fontCache, {shelf.usedWidth, shelf.posY, width, height});
+
+  shelf.usedWidth += width + GLYPH_PADDING;
+  shelf.lastUsedFrame = fontCache->frame;
+  if(shelfMask)
+  {
+    *shelfMask |= 1ull << shelfIdx;
+  }
+
+  CachedGlyph cachedGlyph = {};
+  cachedGlyph.codepoint = codepoint;
+  cachedGlyph.shelfIdx = shelfIdx;
+  cachedGlyph.glyph = glyph;
+  fontCache->glyphSlots[slotIdx] = fontCache->glyphs.add(cachedGlyph) + 1;
+
+  return glyph;
+}
+
+// Keeps the Shelves of a cached Text alive, like get_glyph() does for single Glyphs
+void touch_glyph_shelves(FontCache* fontCache, uint64_t shelfMask)
+{
+  while(shelfMask)
+  {
+    int shelfIdx = __builtin_ctzll(shelfMask);
+    fontCache->shelves[shelfIdx].lastUsedFrame = fontCache->frame;
+    shelfMask &= shelfMask - 1;
+  }
+}
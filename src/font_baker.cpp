@@ -0,0 +1,91 @@
+// #############################################################################
+//                           Font Baker
+// #############################################################################
+// Rasterizes the printable ASCII Glyphs of a TTF File into the Font Atlas and
+// writes it together with the Glyph metrics into a File, see BakedFontHeader.
+// The Renderer loads it instead of opening the TTF with FreeType, see load_font()
+//
+// Usage: font_baker ttfPath fontSize outputPath
+#include "font.h"
+
+#include <stdlib.h>
+
+// #############################################################################
+//                           Font Baker Constants
+// #############################################################################
+constexpr uint32_t BAKED_FIRST_CODEPOINT = 32;
+constexpr uint32_t BAKED_LAST_CODEPOINT = 126;
+
+int main(int argc, char** argv)
+{
+  if(argc != 4)
+  {
+    SM_ERROR("Usage: font_baker ttfPath fontSize outputPath");
+    return 1;
+  }
+
+  char* ttfPath = argv[1];
+  int fontSize = atoi(argv[2]);
+  char* outputPath = argv[3];
+
+  // Too big for the Stack
+  FontCache* fontCache = (FontCache*)calloc(1, sizeof(FontCache));
+  if(strlen(ttfPath) >= sizeof(fontCache->fontPath) || fontSize <= 0)
+  {
+    SM_ERROR("Invalid Font: %s, size %d", ttfPath, fontSize);
+    return 1;
+  }
+  strcpy(fontCache->fontPath, ttfPath);
+  fontCache->fontSize = fontSize;
+
+  if(!load_font_face(fontCache))
+  {
+    return 1;
+  }
+
+  for(uint32_t codepoint = BAKED_FIRST_CODEPOINT; codepoint <= BAKED_LAST_CODEPOINT; codepoint++)
+  {
+    get_glyph(fontCache, codepoint);
+  }
+
+  // The Renderer only uses the baked Font if it was made from the same TTF File
+  long ttfSize = get_file_size(ttfPath);
+  char* ttf = (char*)malloc(ttfSize + 1);
+  int readSize = 0;
+  if(!ttfSize || !ttf || !read_file(ttfPath, &readSize, ttf))
+  {
+    return 1;
+  }
+
+  BakedFontHeader header = {};
+  header.magic = BAKED_FONT_MAGIC;
+  header.version = BAKED_FONT_VERSION;
+  header.ttfHash = hash_bytes(ttf, readSize);
+  header.fontSize = fontSize;
+  header.fontHeight = fontCache->fontHeight;
+  header.glyphHeight = fontCache->glyphHeight;
+  header.atlasSize = FONT_ATLAS_SIZE;
+  header.glyphCount = fontCache->glyphs.count;
+  header.shelfCount = fontCache->shelves.count;
+
+  int glyphsSize = sizeof(CachedGlyph) * header.glyphCount;
+  int shelvesSize = sizeof(GlyphShelf) * header.shelfCount;
+  int atlasSize = FONT_ATLAS_SIZE * FONT_ATLAS_SIZE;
+  int fileSize = sizeof(BakedFontHeader) + glyphsSize + shelvesSize + atlasSize;
+
+  char* buffer = (char*)malloc(fileSize);
+  char* cursor = buffer;
+  memcpy(cursor, &header, sizeof(BakedFontHeader));
+  cursor += sizeof(BakedFontHeader);
+  memcpy(cursor, fontCache->glyphs.elements, glyphsSize);
+  cursor += glyphsSize;
+  memcpy(cursor, fontCache->shelves.elements, shelvesSize);
+  cursor += shelvesSize;
+  memcpy(cursor, fontCache->atlas, atlasSize);
+
+  write_file(outputPath, buffer, fileSize);
+  SM_TRACE("Baked %d Glyphs of %s, size %d into %s",
+           header.glyphCount, ttfPath, fontSize, outputPath);
+
+  return 0;
+}
@@ -6,6 +6,21 @@
 // #############################################################################
 //                           Game Constants
 // #############################################################################
+// Neighbouring Tiles                    Top    Left      Right       Bottom  
+constexpr int NEIGHBOUR_OFFSETS[24] = { 0,-1,  -1, 0,     1, 0,       0, 1,   
+//                                     Topleft Topright Bottomleft Bottomright
+                                       -1,-1,   1,-1,    -1, 1,       1, 1,
+//                                      Top2   Left2     Right2      Bottom2
+                                        0,-2,  -2, 0,     2, 0,       0, 2};
+
+// Topleft     = BIT(4) = 16
+// Toplright   = BIT(5) = 32
+// Bottomleft  = BIT(6) = 64
+// Bottomright = BIT(7) = 128
+
+// Shared by the Player and the Actors
+constexpr float GRAVITY = 13.0f;
+constexpr float FALL_SPEED = 3.6f;
 
 // #############################################################################
 //                           Game Structs
@@ -76,6 +91,59 @@ IRect get_player_rect()
   };
 }
 
+IRect get_actor_rect(int actorIdx)
+{
+  Actors& actors = gameState->actors;
+  return 
+  {
+    actors.posX[actorIdx] - actors.sizeX[actorIdx] / 2,
+    actors.posY[actorIdx] - actors.sizeY[actorIdx] / 2,
+    actors.sizeX[actorIdx],
+    actors.sizeY[actorIdx]
+  };
+}
+
+int spawn_actor(IVec2 pos, IVec2 size, Vec2 speed, ActorFlags flags)
+{
+  Actors& actors = gameState->actors;
+  SM_ASSERT(actors.count < MAX_ACTORS, "Actors are full!");
+
+  int actorIdx = actors.count++;
+  actors.posX[actorIdx] = pos.x;
+  actors.posY[actorIdx] = pos.y;
+  actors.prevPosX[actorIdx] = pos.x;
+  actors.prevPosY[actorIdx] = pos.y;
+  actors.sizeX[actorIdx] = size.x;
+  actors.sizeY[actorIdx] = size.y;
+  actors.remainderX[actorIdx] = 0.0f;
+  actors.remainderY[actorIdx] = 0.0f;
+  actors.speedX[actorIdx] = speed.x;
+  actors.speedY[actorIdx] = speed.y;
+  actors.flags[actorIdx] = flags;
+
+  return actorIdx;
+}
+
+// Swaps the last Actor into the slot, so Actor indices are not stable
+void remove_actor(int actorIdx)
+{
+  Actors& actors = gameState->actors;
+  SM_ASSERT(actorIdx >= 0 && actorIdx < actors.count, "Actor out of bounds: %d", actorIdx);
+
+  int lastIdx = --actors.count;
+  actors.posX[actorIdx] = actors.posX[lastIdx];
+  actors.posY[actorIdx] = actors.posY[lastIdx];
+  actors.prevPosX[actorIdx] = actors.prevPosX[lastIdx];
+  actors.prevPosY[actorIdx] = actors.prevPosY[lastIdx];
+  actors.sizeX[actorIdx] = actors.sizeX[lastIdx];
+  actors.sizeY[actorIdx] = actors.sizeY[lastIdx];
+  actors.remainderX[actorIdx] = actors.remainderX[lastIdx];
+  actors.remainderY[actorIdx] = actors.remainderY[lastIdx];
+  actors.speedX[actorIdx] = actors.speedX[lastIdx];
+  actors.speedY[actorIdx] = actors.speedY[lastIdx];
+  actors.flags[actorIdx] = actors.flags[lastIdx];
+}
+
 IVec2 get_tile_pos(int x, int y)
 {
   return {x * TILESIZE, y * TILESIZE};
@@ -86,12 +154,853 @@ IRect get_tile_rect(int x, int y)
   return {get_tile_pos(x, y), 8, 8};
 }
 
+// Rounds down for negative Positions as well, unlike get_grid_pos()
+int get_tile_coord(int worldCoord)
+{
+  return worldCoord >= 0? worldCoord / TILESIZE : (worldCoord - TILESIZE + 1) / TILESIZE;
+}
+
+void set_tile_visible(int x, int y, bool isVisible)
+{
+  Tile* tile = get_tile(x, y);
+  SM_ASSERT(tile, "Tile out of bounds: %d, %d", x, y);
+
+  if(tile->isVisible == isVisible)
+  {
+    return;
+  }
+
+  tile->isVisible = isVisible;
+
+  uint64_t bit = 1ull << (x % 64);
+  gameState->dirtyTileBits[y][x / 64] |= bit;
+  if(isVisible)
+  {
+    gameState->tileBits[y][x / 64] |= bit;
+  }
+  else
+  {
+    gameState->tileBits[y][x / 64] &= ~bit;
+  }
+}
+
+// Bits of the columns minX to maxX that fall into the word wordIdx of a row
+uint64_t get_tile_column_mask(int wordIdx, int minX, int maxX)
+{
+  int firstBit = max(minX - wordIdx * 64, 0);
+  int lastBit = min(maxX - wordIdx * 64, 63);
+  if(firstBit > lastBit)
+  {
+    return 0;
+  }
+
+  return (~0ull >> (63 - lastBit)) & (~0ull << firstBit);
+}
+
+// Shifts a row of Tile bits by shift columns, positive shifts move
+// towards higher columns, columns outside of the World are cleared
+void shift_tile_row(uint64_t* row, uint64_t* result, int shift)
+{
+  SM_ASSERT(shift > -64 && shift < 64, "Can't shift by more than 63 columns!");
+
+  for(int wordIdx = 0; wordIdx < TILE_ROW_WORDS; wordIdx++)
+  {
+    uint64_t word = row[wordIdx];
+    if(shift > 0)
+    {
+      word = row[wordIdx] << shift;
+      if(wordIdx > 0)
+      {
+        word |= row[wordIdx - 1] >> (64 - shift);
+      }
+    }
+    else if(shift < 0)
+    {
+      word = row[wordIdx] >> -shift;
+      if(wordIdx + 1 < TILE_ROW_WORDS)
+      {
+        word |= row[wordIdx + 1] << (64 + shift);
+      }
+    }
+
+    result[wordIdx] = word;
+  }
+
+  result[TILE_ROW_WORDS - 1] &= get_tile_column_mask(TILE_ROW_WORDS - 1, 0, WORLD_GRID.x - 1);
+}
+
+// Tests the Tile rows under the rect with one mask and per word
+bool tile_collision(IRect rect)
+{
+  int minX = max(get_tile_coord(rect.pos.x), 0);
+  int minY = max(get_tile_coord(rect.pos.y), 0);
+  int maxX = min(get_tile_coord(rect.pos.x + rect.size.x - 1), WORLD_GRID.x - 1);
+  int maxY = min(get_tile_coord(rect.pos.y + rect.size.y - 1), WORLD_GRID.y - 1);
+
+  for(int wordIdx = minX / 64; minX <= maxX && wordIdx <= maxX / 64; wordIdx++)
+  {
+    uint64_t columnMask = get_tile_column_mask(wordIdx, minX, maxX);
+    for(int y = minY; y <= maxY; y++)
+    {
+      if(gameState->tileBits[y][wordIdx] & columnMask)
+      {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Bit x of result is set if the Tile at (x + offsetX, y) is visible,
+// Tiles outside of the World count as visible, like the edge of the World
+void get_neighbour_row(int y, int offsetX, uint64_t* result)
+{
+  if(y < 0 || y >= WORLD_GRID.y)
+  {
+    memset(result, 0xff, sizeof(uint64_t) * TILE_ROW_WORDS);
+    return;
+  }
+
+  shift_tile_row(gameState->tileBits[y], result, -offsetX);
+
+  int minX = offsetX < 0? 0 : WORLD_GRID.x - offsetX;
+  int maxX = offsetX < 0? -offsetX - 1 : WORLD_GRID.x - 1;
+  for(int wordIdx = 0; offsetX && wordIdx < TILE_ROW_WORDS; wordIdx++)
+  {
+    result[wordIdx] |= get_tile_column_mask(wordIdx, minX, maxX);
+  }
+}
+
+// Autotiling, picks the Tile from the 12 surrounding Tiles. Works on 64 Tiles
+// at once, every neighbour is a shifted row of the Bitboard, the rules are
+// evaluated with bit operations and the result is kept as 5 bit planes
+void autotile_row(int y, uint64_t* updateRow)
+{
+  uint64_t neighbours[12][TILE_ROW_WORDS];
+  for(int n = 0; n < 12; n++)
+  {
+    get_neighbour_row(y + NEIGHBOUR_OFFSETS[n * 2 + 1], NEIGHBOUR_OFFSETS[n * 2], neighbours[n]);
+  }
+
+  for(int wordIdx = 0; wordIdx < TILE_ROW_WORDS; wordIdx++)
+  {
+    // Only visible Tiles are drawn, so only they need a mask
+    uint64_t tiles = updateRow[wordIdx] & gameState->tileBits[y][wordIdx];
+    if(!tiles)
+    {
+      continue;
+    }
+
+    uint64_t top = neighbours[0][wordIdx];
+    uint64_t left = neighbours[1][wordIdx];
+    uint64_t right = neighbours[2][wordIdx];
+    uint64_t bottom = neighbours[3][wordIdx];
+    uint64_t topLeft = neighbours[4][wordIdx];
+    uint64_t topRight = neighbours[5][wordIdx];
+    uint64_t bottomLeft = neighbours[6][wordIdx];
+    uint64_t bottomRight = neighbours[7][wordIdx];
+
+    uint64_t sides = top & left & right & bottom;
+    uint64_t extended = neighbours[8][wordIdx] & neighbours[9][wordIdx] &
+                        neighbours[10][wordIdx] & neighbours[11][wordIdx];
+
+    // 7 direct neighbours and the missing one is a diagonal
+    uint64_t cornerTopLeft = sides & ~topLeft & topRight & bottomLeft & bottomRight;
+    uint64_t cornerTopRight = sides & topLeft & ~topRight & bottomLeft & bottomRight;
+    uint64_t cornerBottomLeft = sides & topLeft & topRight & ~bottomLeft & bottomRight;
+    uint64_t cornerBottomRight = sides & topLeft & topRight & bottomLeft & ~bottomRight;
+
+    // All 12 neighbours, black inside
+    uint64_t inside = sides & topLeft & topRight & bottomLeft & bottomRight & extended;
+
+    uint64_t corners = cornerTopLeft | cornerTopRight | cornerBottomLeft | cornerBottomRight;
+    uint64_t edges = ~(corners | inside);
+
+    // Corners are 16 + (emptyNeighbourSlot - 4), inside is 20,
+    // everything else is the mask of the 4 direct neighbours
+    uint64_t planes[5];
+    planes[0] = (edges & top) | cornerTopRight | cornerBottomRight;
+    planes[1] = (edges & left) | cornerBottomLeft | cornerBottomRight;
+    planes[2] = (edges & right) | inside;
+    planes[3] = edges & bottom;
+    planes[4] = corners | inside;
+
+    while(tiles)
+    {
+      int bitIdx = __builtin_ctzll(tiles);
+      tiles &= tiles - 1;
+
+      int neighbourMask = 0;
+      for(int planeIdx = 0; planeIdx < 5; planeIdx++)
+      {
+        neighbourMask |= ((planes[planeIdx] >> bitIdx) & 1) << planeIdx;
+      }
+
+      gameState->worldGrid[wordIdx * 64 + bitIdx][y].neighbourMask = neighbourMask;
+    }
+  }
+}
+
+// Only the Tiles up to 2 Tiles away from a changed Tile need a new mask,
+// the dirty rows are widened by 2 columns and spread 2 rows up and down
+void autotile_dirty_tiles()
+{
+  uint64_t updateBits[WORLD_GRID.y][TILE_ROW_WORDS] = {};
+  bool anyTileChanged = false;
+
+  for(int y = 0; y < WORLD_GRID.y; y++)
+  {
+    uint64_t* dirtyRow = gameState->dirtyTileBits[y];
+
+    uint64_t anyDirty = 0;
+    for(int wordIdx = 0; wordIdx < TILE_ROW_WORDS; wordIdx++)
+    {
+      anyDirty |= dirtyRow[wordIdx];
+    }
+    if(!anyDirty)
+    {
+      continue;
+    }
+    anyTileChanged = true;
+
+    uint64_t wideRow[TILE_ROW_WORDS] = {};
+    for(int shift = -2; shift <= 2; shift++)
+    {
+      uint64_t shiftedRow[TILE_ROW_WORDS];
+      shift_tile_row(dirtyRow, shiftedRow, shift);
+      for(int wordIdx = 0; wordIdx < TILE_ROW_WORDS; wordIdx++)
+      {
+        wideRow[wordIdx] |= shiftedRow[wordIdx];
+      }
+    }
+
+    for(int updateY = max(y - 2, 0); updateY <= min(y + 2, WORLD_GRID.y - 1); updateY++)
+    {
+      for(int wordIdx = 0; wordIdx < TILE_ROW_WORDS; wordIdx++)
+      {
+        updateBits[updateY][wordIdx] |= wideRow[wordIdx];
+      }
+    }
+  }
+
+  if(!anyTileChanged)
+  {
+    return;
+  }
+
+  memset(gameState->dirtyTileBits, 0, sizeof(gameState->dirtyTileBits));
+  gameState->tileGeneration++;
+
+  for(int y = 0; y < WORLD_GRID.y; y++)
+  {
+    autotile_row(y, updateBits[y]);
+  }
+}
+
+// Bulk path, recomputes the mask of every visible Tile, used when the whole Grid changes
+void autotile_all_tiles()
+{
+  memset(gameState->dirtyTileBits, 0, sizeof(gameState->dirtyTileBits));
+  gameState->tileGeneration++;
+
+  uint64_t allTiles[TILE_ROW_WORDS];
+  memset(allTiles, 0xff, sizeof(allTiles));
+
+  for(int y = 0; y < WORLD_GRID.y; y++)
+  {
+    autotile_row(y, allTiles);
+  }
+}
+
 IRect get_solid_rect(Solid solid)
 {
   Sprite sprite = get_sprite(solid.spriteID);
   return {solid.pos - sprite.size / 2, sprite.size};
 }
 
+int get_solid_grid_bucket(int cellX, int cellY)
+{
+  unsigned int hash = ((unsigned int)cellX * 73856093u) ^ ((unsigned int)cellY * 19349663u);
+  return hash & (SOLID_GRID_BUCKET_COUNT - 1);
+}
+
+// Sorts all Solids into the Buckets of the Cells they overlap, 
+// called once per tick, before anything queries the Solids
+void build_solid_grid()
+{
+  SolidGrid& grid = gameState->solidGrid;
+  memset(grid.bucketStart, 0, sizeof(grid.bucketStart));
+
+  // Count the Entries per Bucket, shifted by one for the prefix sum
+  for(int solidIdx = 0; solidIdx < gameState->solids.count; solidIdx++)
+  {
+    IRect solidRect = get_solid_rect(gameState->solids[solidIdx]);
+    grid.solidRects[solidIdx] = solidRect;
+
+    for(int cellY = solidRect.pos.y >> SOLID_GRID_CELL_SHIFT; 
+        cellY <= (solidRect.pos.y + solidRect.size.y - 1) >> SOLID_GRID_CELL_SHIFT; cellY++)
+    {
+      for(int cellX = solidRect.pos.x >> SOLID_GRID_CELL_SHIFT; 
+          cellX <= (solidRect.pos.x + solidRect.size.x - 1) >> SOLID_GRID_CELL_SHIFT; cellX++)
+      {
+        grid.bucketStart[get_solid_grid_bucket(cellX, cellY) + 1]++;
+      }
+    }
+  }
+
+  for(int bucketIdx = 0; bucketIdx < SOLID_GRID_BUCKET_COUNT; bucketIdx++)
+  {
+    grid.bucketStart[bucketIdx + 1] += grid.bucketStart[bucketIdx];
+  }
+  grid.entryCount = grid.bucketStart[SOLID_GRID_BUCKET_COUNT];
+  SM_ASSERT(grid.entryCount <= MAX_SOLID_GRID_ENTRIES, "Solid Grid is full!");
+
+  // Fill the Buckets
+  int bucketCursor[SOLID_GRID_BUCKET_COUNT];
+  memcpy(bucketCursor, grid.bucketStart, sizeof(bucketCursor));
+  for(int solidIdx = 0; solidIdx < gameState->solids.count; solidIdx++)
+  {
+    IRect solidRect = grid.solidRects[solidIdx];
+
+    for(int cellY = solidRect.pos.y >> SOLID_GRID_CELL_SHIFT; 
+        cellY <= (solidRect.pos.y + solidRect.size.y - 1) >> SOLID_GRID_CELL_SHIFT; cellY++)
+    {
+      for(int cellX = solidRect.pos.x >> SOLID_GRID_CELL_SHIFT; 
+          cellX <= (solidRect.pos.x + solidRect.size.x - 1) >> SOLID_GRID_CELL_SHIFT; cellX++)
+      {
+        grid.entries[bucketCursor[get_solid_grid_bucket(cellX, cellY)]++] = solidIdx;
+      }
+    }
+  }
+}
+
+// Returns the first step (1, 2, ...) at which the moving range overlaps 
+// the other range, or 0 if they never overlap
+int get_first_contact(int pos, int size, int otherPos, int otherSize, int moveSign)
+{
+  int firstStep = moveSign > 0? otherPos - (pos + size) + 1 : pos - (otherPos + otherSize) + 1;
+  int lastStep = moveSign > 0? otherPos + otherSize - pos - 1 : pos + size - otherPos - 1;
+  firstStep = max(firstStep, 1);
+
+  return firstStep <= lastStep? firstStep : 0;
+}
+
+// Moves the rect along one axis in a single query, returns how many Pixels it can
+// move before it overlaps a Solid or a visible Tile. This gives the same result
+// as stepping one Pixel at a time and testing for collision after every step.
+int sweep_rect(IRect rect, int moveX, int moveY, bool* collisionHappened)
+{
+  SM_ASSERT(!moveX || !moveY, "Can only sweep along one axis!");
+
+  bool alongX = moveX != 0;
+  int move = alongX? moveX : moveY;
+  int moveSign = sign(move);
+  int steps = abs(move);
+  int firstContact = steps + 1;
+
+  // Area covered by all the steps
+  IRect sweptRect = rect;
+  if(alongX)
+  {
+    sweptRect.pos.x += moveSign > 0? 1 : -steps;
+    sweptRect.size.x += steps - 1;
+  }
+  else
+  {
+    sweptRect.pos.y += moveSign > 0? 1 : -steps;
+    sweptRect.size.y += steps - 1;
+  }
+
+  auto test_contact = [&](IRect other)
+  {
+    int contact = 0;
+    if(alongX)
+    {
+      if(rect.pos.y < other.pos.y + other.size.y && rect.pos.y + rect.size.y > other.pos.y)
+      {
+        contact = get_first_contact(rect.pos.x, rect.size.x, other.pos.x, other.size.x, moveSign);
+      }
+    }
+    else
+    {
+      if(rect.pos.x < other.pos.x + other.size.x && rect.pos.x + rect.size.x > other.pos.x)
+      {
+        contact = get_first_contact(rect.pos.y, rect.size.y, other.pos.y, other.size.y, moveSign);
+      }
+    }
+
+    if(contact && contact < firstContact)
+    {
+      firstContact = contact;
+    }
+  };
+
+  // Test against Solids in the swept Cells
+  {
+    SolidGrid& grid = gameState->solidGrid;
+
+    for(int cellY = sweptRect.pos.y >> SOLID_GRID_CELL_SHIFT; 
+        cellY <= (sweptRect.pos.y + sweptRect.size.y - 1) >> SOLID_GRID_CELL_SHIFT; cellY++)
+    {
+      for(int cellX = sweptRect.pos.x >> SOLID_GRID_CELL_SHIFT; 
+          cellX <= (sweptRect.pos.x + sweptRect.size.x - 1) >> SOLID_GRID_CELL_SHIFT; cellX++)
+      {
+        int bucketIdx = get_solid_grid_bucket(cellX, cellY);
+        for(int entryIdx = grid.bucketStart[bucketIdx]; 
+            entryIdx < grid.bucketStart[bucketIdx + 1]; entryIdx++)
+        {
+          test_contact(grid.solidRects[grid.entries[entryIdx]]);
+        }
+      }
+    }
+  }
+
+  // Test against the visible Tiles in the swept Area, the Tile
+  // rows and columns under the swept Area are found with bit masks
+  {
+    int minX = max(get_tile_coord(sweptRect.pos.x), 0);
+    int minY = max(get_tile_coord(sweptRect.pos.y), 0);
+    int maxX = min(get_tile_coord(sweptRect.pos.x + sweptRect.size.x - 1), WORLD_GRID.x - 1);
+    int maxY = min(get_tile_coord(sweptRect.pos.y + sweptRect.size.y - 1), WORLD_GRID.y - 1);
+
+    if(alongX && minX <= maxX)
+    {
+      // Combine the rows, the nearest set column in move direction is the first contact
+      int firstWord = minX / 64;
+      int lastWord = maxX / 64;
+      for(int wordIdx = moveSign > 0? firstWord : lastWord; 
+          wordIdx >= firstWord && wordIdx <= lastWord; wordIdx += moveSign)
+      {
+        uint64_t bits = 0;
+        for(int y = minY; y <= maxY; y++)
+        {
+          bits |= gameState->tileBits[y][wordIdx];
+        }
+        bits &= get_tile_column_mask(wordIdx, minX, maxX);
+
+        if(bits)
+        {
+          int x = wordIdx * 64 + (moveSign > 0? __builtin_ctzll(bits) : 63 - __builtin_clzll(bits));
+          test_contact(get_tile_rect(x, minY));
+          break;
+        }
+      }
+    }
+
+    if(!alongX && minX <= maxX)
+    {
+      // Walk the rows in move direction, the first row with a set column is the first contact
+      for(int y = moveSign > 0? minY : maxY; y >= minY && y <= maxY; y += moveSign)
+      {
+        bool rowCollision = false;
+        for(int wordIdx = minX / 64; wordIdx <= maxX / 64; wordIdx++)
+        {
+          rowCollision |= (gameState->tileBits[y][wordIdx] & 
+                           get_tile_column_mask(wordIdx, minX, maxX)) != 0;
+        }
+
+        if(rowCollision)
+        {
+          test_contact(get_tile_rect(minX, y));
+          break;
+        }
+      }
+    }
+  }
+
+  *collisionHappened = firstContact <= steps;
+  return firstContact - 1;
+}
+
+// Integer movement shared by the Player and the Actors, the speed is collected
+// in the remainder and only whole Pixels are moved, up to the first contact.
+// Returns the signed distance moved along the axis.
+int move_actor(IRect rect, float speed, float* remainder, bool alongX, bool* collisionHappened)
+{
+  *collisionHappened = false;
+
+  *remainder += speed;
+  int move = round(*remainder);
+  if(move == 0)
+  {
+    return 0;
+  }
+  *remainder -= move;
+
+  int moveDistance = sweep_rect(rect, alongX? move : 0, alongX? 0 : move, collisionHappened);
+  return sign(move) * moveDistance;
+}
+
+// Copies the simulated part of the GameState into data or back, only the used part
+// of the Arrays is copied. The Solid Grid is rebuilt every tick and the Tileset and
+// Key Mappings never change after init, so they are skipped. Returns the size,
+// passing nullptr for data only counts it.
+int transfer_snapshot(char* data, bool save, bool includeTiles)
+{
+  int size = 0;
+  auto transfer = [&](void* field, int fieldSize, bool copy)
+  {
+    if(data && copy)
+    {
+      if(save)
+      {
+        memcpy(data + size, field, fieldSize);
+      }
+      else
+      {
+        memcpy(field, data + size, fieldSize);
+      }
+    }
+    size += fieldSize;
+  };
+
+  transfer(&gameState->tick, sizeof(gameState->tick), true);
+  transfer(&gameState->player, sizeof(gameState->player), true);
+
+  // The count is restored first, so the arrays use the restored count
+  Actors& actors = gameState->actors;
+  transfer(&actors.count, sizeof(actors.count), true);
+  transfer(actors.posX, sizeof(int) * actors.count, true);
+  transfer(actors.posY, sizeof(int) * actors.count, true);
+  transfer(actors.sizeX, sizeof(int) * actors.count, true);
+  transfer(actors.sizeY, sizeof(int) * actors.count, true);
+  transfer(actors.remainderX, sizeof(float) * actors.count, true);
+  transfer(actors.remainderY, sizeof(float) * actors.count, true);
+  transfer(actors.speedX, sizeof(float) * actors.count, true);
+  transfer(actors.speedY, sizeof(float) * actors.count, true);
+  transfer(actors.flags, sizeof(ActorFlags) * actors.count, true);
+
+  transfer(&gameState->solids.count, sizeof(gameState->solids.count), true);
+  transfer(gameState->solids.elements, sizeof(Solid) * gameState->solids.count, true);
+
+  transfer(gameState->worldGrid, sizeof(gameState->worldGrid), includeTiles);
+  transfer(gameState->tileBits, sizeof(gameState->tileBits), includeTiles);
+
+  return size;
+}
+
+void restore_snapshot(char* data, bool includeTiles)
+{
+  transfer_snapshot(data, false, includeTiles);
+
+  // Nothing to interpolate from
+  Actors& actors = gameState->actors;
+  memcpy(actors.prevPosX, actors.posX, sizeof(int) * actors.count);
+  memcpy(actors.prevPosY, actors.posY, sizeof(int) * actors.count);
+
+  // The masks are part of the Snapshot
+  if(includeTiles)
+  {
+    memset(gameState->dirtyTileBits, 0, sizeof(gameState->dirtyTileBits));
+    gameState->tileGeneration++;
+  }
+}
+
+Snapshot* get_snapshot(int snapshotIdx)
+{
+  SM_ASSERT(snapshotIdx >= 0 && snapshotIdx < snapshotState->snapshotCount, 
+            "Snapshot out of bounds: %d", snapshotIdx);
+  return &snapshotState->snapshots[(snapshotState->firstSnapshotIdx + snapshotIdx) % MAX_SNAPSHOTS];
+}
+
+// Appends the current tick to the ring, drops the oldest Snapshots to make room
+void take_snapshot()
+{
+  int size = transfer_snapshot(nullptr, true, true);
+  SM_ASSERT(size <= SNAPSHOT_BUFFER_SIZE, "Snapshot doesn't fit into the Buffer: %d", size);
+
+  int offset = 0;
+  if(snapshotState->snapshotCount)
+  {
+    Snapshot* newest = get_snapshot(snapshotState->snapshotCount - 1);
+    offset = newest->offset + newest->size;
+  }
+  // Snapshots behind the newest one are older than the ones at the start of the Buffer
+  int tailOffset = SNAPSHOT_BUFFER_SIZE;
+  if(offset + size > SNAPSHOT_BUFFER_SIZE)
+  {
+    tailOffset = offset;
+    offset = 0;
+  }
+
+  // Snapshots are laid out in ring order, so only the oldest one can be in the
+  // way of the new one, they are dropped until it isn't
+  while(snapshotState->snapshotCount)
+  {
+    Snapshot* oldest = get_snapshot(0);
+    bool inTail = oldest->offset >= tailOffset;
+    bool overlaps = oldest->offset < offset + size && oldest->offset + oldest->size > offset;
+    if(snapshotState->snapshotCount < MAX_SNAPSHOTS && !inTail && !overlaps)
+    {
+      break;
+    }
+
+    snapshotState->firstSnapshotIdx = (snapshotState->firstSnapshotIdx + 1) % MAX_SNAPSHOTS;
+    snapshotState->snapshotCount--;
+  }
+
+  Snapshot* snapshot = &snapshotState->snapshots[
+    (snapshotState->firstSnapshotIdx + snapshotState->snapshotCount++) % MAX_SNAPSHOTS];
+  snapshot->tick = gameState->tick;
+  snapshot->offset = offset;
+  snapshot->size = size;
+
+  transfer_snapshot(snapshotState->buffer + offset, true, true);
+}
+
+// Restores the Snapshot of tick and drops all newer ones, the ticks 
+// in the ring are consecutive, so the Snapshot is found by its distance
+bool rewind_to_tick(int tick)
+{
+  if(!snapshotState->snapshotCount)
+  {
+    return false;
+  }
+
+  int snapshotIdx = tick - get_snapshot(0)->tick;
+  if(snapshotIdx < 0 || snapshotIdx >= snapshotState->snapshotCount)
+  {
+    return false;
+  }
+
+  Snapshot* snapshot = get_snapshot(snapshotIdx);
+  SM_ASSERT(snapshot->tick == tick, "Snapshot ticks are not consecutive!");
+
+  restore_snapshot(snapshotState->buffer + snapshot->offset, true);
+  snapshotState->snapshotCount = snapshotIdx + 1;
+
+  return true;
+}
+
+void save_checkpoint()
+{
+  SM_ASSERT(transfer_snapshot(nullptr, true, true) <= sizeof(GameState), "Checkpoint too large!");
+  snapshotState->checkpointSize = transfer_snapshot(snapshotState->checkpoint, true, true);
+}
+
+// Restarts the Level from the Checkpoint, but keeps the edited Tiles and the tick count
+void restore_checkpoint()
+{
+  SM_ASSERT(snapshotState->checkpointSize, "No Checkpoint saved!");
+
+  int tick = gameState->tick;
+  restore_snapshot(snapshotState->checkpoint, false);
+  gameState->tick = tick;
+}
+
+// Appends the Input this tick consumes to the Replay Log
+void record_replay_tick()
+{
+  constexpr int maxTickSize = 2 + sizeof(ReplayKey) * KEY_COUNT + sizeof(IVec2) * 4;
+  if(replayState->size + (int)sizeof(ReplayHeader) + maxTickSize > REPLAY_BUFFER_SIZE)
+  {
+    SM_WARN("Replay Buffer is full, stopped recording after %d ticks", replayState->tickCount);
+    replayState->mode = REPLAY_MODE_OFF;
+    return;
+  }
+
+  auto write = [&](void* data, int size)
+  {
+    memcpy(replayState->buffer + replayState->size, data, size);
+    replayState->size += size;
+  };
+
+  if(!replayState->size)
+  {
+    ReplayHeader header = {REPLAY_MAGIC, REPLAY_VERSION, input->screenSize, gameState->state};
+    write(&header, sizeof(header));
+    replayState->screenSize = input->screenSize;
+  }
+
+  unsigned char flags = 0;
+  if(!replayState->tickCount ||
+     input->mousePos != replayState->mousePos || 
+     input->mousePosWorld != replayState->mousePosWorld)
+  {
+    flags |= REPLAY_TICK_MOUSE;
+  }
+  if(input->screenSize != replayState->screenSize)
+  {
+    flags |= REPLAY_TICK_SCREEN_SIZE;
+  }
+
+  // Only Keys with transitions change, isDown stays the same otherwise
+  ReplayKey replayKeys[KEY_COUNT];
+  unsigned char keyCount = 0;
+  for(int keyCode = 0; keyCode < KEY_COUNT; keyCode++)
+  {
+    Key& key = input->keys[keyCode];
+    if(key.halfTransitionCount || key.justPressed || key.justReleased)
+    {
+      replayKeys[keyCount++] = 
+      {
+        (unsigned char)keyCode, 
+        (unsigned char)key.isDown, 
+        (unsigned char)key.justPressed, 
+        (unsigned char)key.justReleased, 
+        key.halfTransitionCount
+      };
+    }
+  }
+
+  write(&flags, sizeof(flags));
+  write(&keyCount, sizeof(keyCount));
+  write(replayKeys, sizeof(ReplayKey) * keyCount);
+
+  if(flags & REPLAY_TICK_MOUSE)
+  {
+    write(&input->mousePos, sizeof(IVec2));
+    write(&input->mousePosWorld, sizeof(IVec2));
+    replayState->mousePos = input->mousePos;
+    replayState->mousePosWorld = input->mousePosWorld;
+  }
+  if(flags & REPLAY_TICK_SCREEN_SIZE)
+  {
+    write(&input->screenSize, sizeof(IVec2));
+    replayState->screenSize = input->screenSize;
+  }
+
+  replayState->tickCount++;
+}
+
+// Overwrites the Input with the next recorded tick, returns false at the end of the Log
+bool play_replay_tick()
+{
+  auto read = [&](void* data, int size)
+  {
+    if(replayState->cursor + size > replayState->size)
+    {
+      return false;
+    }
+
+    memcpy(data, replayState->buffer + replayState->cursor, size);
+    replayState->cursor += size;
+    return true;
+  };
+
+  if(!replayState->cursor)
+  {
+    ReplayHeader header = {};
+    if(!read(&header, sizeof(header)) || 
+       header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION)
+    {
+      SM_ERROR("Not a Replay or wrong Version");
+      replayState->finished = true;
+      replayState->corrupt = true;
+      return false;
+    }
+
+    input->screenSize = header.screenSize;
+    gameState->state = (GameStateID)header.startState;
+  }
+
+  // The Log ends cleanly between two ticks
+  if(replayState->cursor == replayState->size)
+  {
+    replayState->finished = true;
+    return false;
+  }
+
+  unsigned char flags = 0;
+  unsigned char keyCount = 0;
+  bool complete = read(&flags, sizeof(flags)) && read(&keyCount, sizeof(keyCount));
+
+  ReplayKey replayKeys[256];
+  for(int keyIdx = 0; complete && keyIdx < keyCount; keyIdx++)
+  {
+    complete = read(&replayKeys[keyIdx], sizeof(ReplayKey)) && 
+               replayKeys[keyIdx].keyCode < KEY_COUNT;
+  }
+
+  IVec2 mousePos = input->mousePos;
+  IVec2 mousePosWorld = input->mousePosWorld;
+  IVec2 screenSize = input->screenSize;
+  if(complete && (flags & REPLAY_TICK_MOUSE))
+  {
+    complete = read(&mousePos, sizeof(IVec2)) && read(&mousePosWorld, sizeof(IVec2));
+  }
+  if(complete && (flags & REPLAY_TICK_SCREEN_SIZE))
+  {
+    complete = read(&screenSize, sizeof(IVec2));
+  }
+
+  if(!complete)
+  {
+    SM_ERROR("Replay is truncated or corrupt after %d ticks", replayState->tickCount);
+    replayState->finished = true;
+    replayState->corrupt = true;
+    return false;
+  }
+
+  for(int keyIdx = 0; keyIdx < keyCount; keyIdx++)
+  {
+    ReplayKey& replayKey = replayKeys[keyIdx];
+
+    Key& key = input->keys[replayKey.keyCode];
+    key.isDown = replayKey.isDown;
+    key.justPressed = replayKey.justPressed;
+    key.justReleased = replayKey.justReleased;
+    key.halfTransitionCount = replayKey.halfTransitionCount;
+  }
+
+  input->mousePos = mousePos;
+  input->mousePosWorld = mousePosWorld;
+  input->screenSize = screenSize;
+
+  replayState->tickCount++;
+  return true;
+}
+
+// Moves all Actors in batches, one pass per step over the arrays
+void update_actors(float dt)
+{
+  Actors& actors = gameState->actors;
+
+  memcpy(actors.prevPosX, actors.posX, sizeof(int) * actors.count);
+  memcpy(actors.prevPosY, actors.posY, sizeof(int) * actors.count);
+
+  // Gravity
+  for(int actorIdx = 0; actorIdx < actors.count; actorIdx++)
+  {
+    if(actors.flags[actorIdx] & ACTOR_FLAG_GRAVITY)
+    {
+      actors.speedY[actorIdx] = approach(actors.speedY[actorIdx], FALL_SPEED, GRAVITY * dt);
+    }
+  }
+
+  // Move X
+  for(int actorIdx = 0; actorIdx < actors.count; actorIdx++)
+  {
+    bool collisionHappened = false;
+    actors.posX[actorIdx] += move_actor(get_actor_rect(actorIdx), actors.speedX[actorIdx],
+                                        &actors.remainderX[actorIdx], true, &collisionHappened);
+    if(collisionHappened)
+    {
+      if(actors.flags[actorIdx] & ACTOR_FLAG_BOUNCE)
+      {
+        actors.speedX[actorIdx] = -actors.speedX[actorIdx];
+      }
+      else
+      {
+        actors.speedX[actorIdx] = 0.0f;
+      }
+    }
+  }
+
+  // Move Y
+  for(int actorIdx = 0; actorIdx < actors.count; actorIdx++)
+  {
+    bool collisionHappened = false;
+    actors.posY[actorIdx] += move_actor(get_actor_rect(actorIdx), actors.speedY[actorIdx],
+                                        &actors.remainderY[actorIdx], false, &collisionHappened);
+    if(collisionHappened)
+    {
+      actors.speedY[actorIdx] = 0.0f;
+    }
+  }
+}
+
 void update_level(float dt)
 {
   if(just_pressed(PAUSE))
@@ -99,20 +1008,31 @@ void update_level(float dt)
     gameState->state = GAME_STATE_MAIN_MENU;
   }
 
+  if(!snapshotState->checkpointSize)
+  {
+    save_checkpoint();
+  }
+
+  // Going back one tick per update, the Simulation is paused while rewinding
+  if(is_down(REWIND))
+  {
+    rewind_to_tick(gameState->tick - 1);
+    return;
+  }
+
+  // Solids only move after the Player and the Actors, so the Grid stays valid for their movement
+  build_solid_grid();
+
   // Update Player
   {
     Player& player = gameState->player;
     player.prevPos = player.pos;
     player.animationState = PLAYER_ANIM_IDLE;
 
-    static Vec2 remainder = {};
-    static bool grounded = false;
     constexpr float runSpeed = 2.0f;
     constexpr float runAcceleration = 10.0f;
     constexpr float runReduce = 22.0f; 
     constexpr float flyReduce = 12.0f;    
-    constexpr float gravity = 13.0f;
-    constexpr float fallSpeed = 3.6f;
     constexpr float jumpSpeed = -3.0f;
 
     // Facing the Player in the right direction
@@ -126,23 +1046,23 @@ void update_level(float dt)
     }
 
     // Jump
-    if(just_pressed(JUMP) && grounded)
+    if(just_pressed(JUMP) && player.grounded)
     {
       player.speed.y = jumpSpeed;
       player.speed.x += player.solidSpeed.x;
       player.speed.y += player.solidSpeed.y;
       play_sound("jump");
-      grounded = false;
+      player.grounded = false;
     }
 
-    if(!grounded)
+    if(!player.grounded)
     {
       player.animationState = PLAYER_ANIM_JUMP;
     }
 
     if(is_down(MOVE_LEFT))
     {
-      if(grounded)
+      if(player.grounded)
       {
         player.animationState = PLAYER_ANIM_RUN;
       }
@@ -158,7 +1078,7 @@ void update_level(float dt)
 
     if(is_down(MOVE_RIGHT))
     {
-      if(grounded)
+      if(player.grounded)
       {
         player.animationState = PLAYER_ANIM_RUN;
       }
@@ -176,7 +1096,7 @@ void update_level(float dt)
     if(!is_down(MOVE_LEFT) &&
       !is_down(MOVE_RIGHT))
     {
-      if(grounded)
+      if(player.grounded)
       {
         player.speed.x = approach(player.speed.x, 0, runReduce * dt);
       }
@@ -187,7 +1107,7 @@ void update_level(float dt)
     }
 
     // Gravity
-    player.speed.y = approach(player.speed.y, fallSpeed, gravity * dt);
+    player.speed.y = approach(player.speed.y, FALL_SPEED, GRAVITY * dt);
 
 
     if(is_down(MOVE_UP))
@@ -197,148 +1117,38 @@ void update_level(float dt)
 
     // Move X
     {
-      IRect playerRect = get_player_rect();
-
-      remainder.x += player.speed.x;
-      int moveX = round(remainder.x);
-      if(moveX != 0)
+      bool collisionHappened = false;
+      player.pos.x += move_actor(get_player_rect(), player.speed.x, 
+                                 &player.remainder.x, true, &collisionHappened);
+      if(collisionHappened)
       {
-        remainder.x -= moveX;
-        int moveSign = sign(moveX);
-        bool collisionHappened = false;
-
-        // Move the player in Y until collision or moveY is exausted
-        auto movePlayerX = [&]
-        {
-          while(moveX)
-          {
-            playerRect.pos.x += moveSign;
-
-            // Test collision against Solids
-            {
-              for(int solidIdx = 0; solidIdx < gameState->solids.count; solidIdx++)
-              {
-                Solid& solid = gameState->solids[solidIdx];
-                IRect solidRect = get_solid_rect(solid);
-
-                if(rect_collision(playerRect, solidRect))
-                {
-                  player.speed.x = 0;
-                  return;
-                }
-              }
-            }
-
-            // Loop through local Tiles
-            IVec2 playerGridPos = get_grid_pos(player.pos);
-            for(int x = playerGridPos.x - 1; x <= playerGridPos.x + 1; x++)
-            {
-              for(int y = playerGridPos.y - 2; y <= playerGridPos.y + 2; y++)
-              {
-                Tile* tile = get_tile(x, y);
-
-                if(!tile || !tile->isVisible)
-                {
-                  continue;
-                }
-
-                IRect tileRect = get_tile_rect(x, y);
-                if(rect_collision(playerRect, tileRect))
-                {
-                  player.speed.x = 0;
-                  return;
-                }
-              }
-            }
-
-            // Move the Player
-            player.pos.x += moveSign;
-            moveX -= moveSign;
-          }
-        };
-        movePlayerX();
+        player.speed.x = 0;
       }
     }
 
     // Move Y
     {
-      IRect playerRect = get_player_rect();
-
-      remainder.y += player.speed.y;
-      int moveY = round(remainder.y);
-      if(moveY != 0)
+      bool collisionHappened = false;
+      player.pos.y += move_actor(get_player_rect(), player.speed.y, 
+                                 &player.remainder.y, false, &collisionHappened);
+      if(collisionHappened)
       {
-        remainder.y -= moveY;
-        int moveSign = sign(moveY);
-        bool collisionHappened = false;
-
-        // Move the player in Y until collision or moveY is exausted
-        auto movePlayerY = [&]
+        // Moving down/falling
+        if(player.speed.y > 0.0f)
         {
-          while(moveY)
-          {
-            playerRect.pos.y += moveSign;
-
-            // Test collision against Solids
-            {
-              for(int solidIdx = 0; solidIdx < gameState->solids.count; solidIdx++)
-              {
-                Solid& solid = gameState->solids[solidIdx];
-                IRect solidRect = get_solid_rect(solid);
-
-                if(rect_collision(playerRect, solidRect))
-                {
-                  // Moving down/falling
-                  if(player.speed.y > 0.0f)
-                  {
-                    grounded = true;
-                  }
-
-                  player.speed.y = 0;
-                  return;
-                }
-              }
-            }
-
-            // Loop through local Tiles
-            IVec2 playerGridPos = get_grid_pos(player.pos);
-            for(int x = playerGridPos.x - 1; x <= playerGridPos.x + 1; x++)
-            {
-              for(int y = playerGridPos.y - 2; y <= playerGridPos.y + 2; y++)
-              {
-                Tile* tile = get_tile(x, y);
-
-                if(!tile || !tile->isVisible)
-                {
-                  continue;
-                }
-
-                IRect tileRect = get_tile_rect(x, y);
-                if(rect_collision(playerRect, tileRect))
-                {
-                  // Moving down/falling
-                  if(player.speed.y > 0.0f)
-                  {
-                    grounded = true;
-                  }
-
-                  player.speed.y = 0;
-                  return;
-                }
-              }
-            }
+          player.grounded = true;
+        }
 
-            // Move the Player
-            player.pos.y += moveSign;
-            moveY -= moveSign;
-          }
-        };
-        movePlayerY();
+        player.speed.y = 0;
       }
     }
   }
 
+  // Update Actors, unlike the Player they don't get pushed by Solids
+  update_actors(dt);
+
   // Update Solids
+  bool playerDied = false;
   {
     Player& player = gameState->player;
     player.solidSpeed = {};
@@ -385,31 +1195,11 @@ void update_level(float dt)
                 player.solidSpeed.x = solid.speed.x * (float)moveSign / 20.0f;
 
                 // Check for collision, if yes, destroy the player
-                // Loop through local Tiles
-                IVec2 playerGridPos = get_grid_pos(player.pos);
-                for(int x = playerGridPos.x - 1; x <= playerGridPos.x + 1; x++)
+                tileCollision = tile_collision(playerRect);
+                if(tileCollision && !standingOnTop)
                 {
-                  for(int y = playerGridPos.y - 2; y <= playerGridPos.y + 2; y++)
-                  {
-                    Tile* tile = get_tile(x, y);
-
-                    if(!tile || !tile->isVisible)
-                    {
-                      continue;
-                    }
-
-                    IRect tileRect = get_tile_rect(x, y);
-                    if(rect_collision(playerRect, tileRect))
-                    {
-                      tileCollision = true;
-
-                      if(!standingOnTop)
-                      {
-                        // Death
-                      player.pos = {WORLD_WIDTH / 2,  WORLD_HEIGHT - 24};
-                      }
-                    }
-                  }
+                  // Death
+                  playerDied = true;
                 }
 
                 if(!tileCollision)
@@ -461,25 +1251,9 @@ void update_level(float dt)
                 player.solidSpeed.y = solid.speed.y * (float)moveSign / 40.0f;
 
                 // Check for collision, if yes, destroy the player
-                // Loop through local Tiles
-                IVec2 playerGridPos = get_grid_pos(player.pos);
-                for(int x = playerGridPos.x - 1; x <= playerGridPos.x + 1; x++)
+                if(tile_collision(playerRect))
                 {
-                  for(int y = playerGridPos.y - 2; y <= playerGridPos.y + 2; y++)
-                  {
-                    Tile* tile = get_tile(x, y);
-
-                    if(!tile || !tile->isVisible)
-                    {
-                      continue;
-                    }
-
-                    IRect tileRect = get_tile_rect(x, y);
-                    if(rect_collision(playerRect, tileRect))
-                    {
-                      player.pos = {WORLD_WIDTH / 2,  WORLD_HEIGHT - 24};
-                    }
-                  }
+                  playerDied = true;
                 }
               }
 
@@ -501,101 +1275,34 @@ void update_level(float dt)
     }
   }
 
-  bool updateTiles = false;
   if(is_down(MOUSE_LEFT) && !ui_is_hot() && !ui_is_active())
   {
-    IVec2 worldPos = screen_to_world(input->mousePos);
-    IVec2 mousePosWorld = input->mousePosWorld;
-    Tile* tile = get_tile(worldPos);
-    if(tile)
+    IVec2 gridPos = get_grid_pos(screen_to_world(input->mousePos));
+    if(get_tile(gridPos.x, gridPos.y))
     {
-      tile->isVisible = true;
-      updateTiles = true;
+      set_tile_visible(gridPos.x, gridPos.y, true);
     }
   }
 
   if(is_down(MOUSE_RIGHT))
   {
-    IVec2 worldPos = screen_to_world(input->mousePos);
-    IVec2 mousePosWorld = input->mousePosWorld;
-    Tile* tile = get_tile(worldPos);
-    if(tile)
+    IVec2 gridPos = get_grid_pos(screen_to_world(input->mousePos));
+    if(get_tile(gridPos.x, gridPos.y))
     {
-      tile->isVisible = false;
-      updateTiles = true;
+      set_tile_visible(gridPos.x, gridPos.y, false);
     }
   }
 
-  if(updateTiles)
-  {
-    // Neighbouring Tiles        Top    Left      Right       Bottom  
-    int neighbourOffsets[24] = { 0,-1,  -1, 0,     1, 0,       0, 1,   
-    //                          Topleft Topright Bottomleft Bottomright
-                                -1,-1,   1,-1,    -1, 1,       1, 1,
-    //                           Top2   Left2     Right2      Bottom2
-                                 0,-2,  -2, 0,     2, 0,       0, 2};
-
-    // Topleft     = BIT(4) = 16
-    // Toplright   = BIT(5) = 32
-    // Bottomleft  = BIT(6) = 64
-    // Bottomright = BIT(7) = 128
-
-    for(int y = 0; y < WORLD_GRID.y; y++)
-    {
-      for(int x = 0; x < WORLD_GRID.x; x++)
-      {
-        Tile* tile = get_tile(x, y);
-
-        if(!tile->isVisible)
-        {
-          continue;
-        }
-
-        tile->neighbourMask = 0;
-        int neighbourCount = 0;
-        int extendedNeighbourCount = 0;
-        int emptyNeighbourSlot = 0;
-
-        // Look at the sorrounding 12 Neighbours
-        for(int n = 0; n < 12; n++)
-        {
-          Tile* neighbour = get_tile(x + neighbourOffsets[n * 2],
-                                     y + neighbourOffsets[n * 2 + 1]);
+  autotile_dirty_tiles();
 
-          // No neighbour means the edge of the world
-          if(!neighbour || neighbour->isVisible)
-          {
-            tile->neighbourMask |= BIT(n);
-            if(n < 8) // Counting direct neighbours
-            {
-              neighbourCount++;
-            }
-            else // Counting neighbours 1 Tile away
-            {
-              extendedNeighbourCount++;
-            }
-          }
-          else if(n < 8)
-          {
-            emptyNeighbourSlot = n;
-          }
-        }
-
-        if(neighbourCount == 7 && emptyNeighbourSlot >= 4) // We have a corner
-        {
-          tile->neighbourMask = 16 + (emptyNeighbourSlot - 4);
-        }
-        else if(neighbourCount == 8 && extendedNeighbourCount == 4)
-        {
-          tile->neighbourMask = 20;
-        }
-        else
-        {
-          tile->neighbourMask = tile->neighbourMask & 0b1111;
-        }
-      }
-    }
+  // Restarting after the Solids are done, so the restored State is not touched by them
+  if(playerDied)
+  {
+    restore_checkpoint();
   }
+
+  gameState->tick++;
+  take_snapshot();
 }
 
 void update_main_menu(float dt)
@@ -657,17 +1364,22 @@ EXPORT_FN void update_game(GameState* gameStateIn,
                            Input* inputIn, 
                            SoundState* soundStateIn,
                            UIState* uiStateIn,
+                           SnapshotState* snapshotStateIn,
+                           ReplayState* replayStateIn,
                            float dt)
 {
   if(renderData != renderDataIn)
   {
     gameState = gameStateIn;
+    snapshotState = snapshotStateIn;
+    replayState = replayStateIn;
     renderData = renderDataIn;
     input = inputIn;
     soundState = soundStateIn;
     uiState = uiStateIn;
 
     init_strings();
+    init_sprites();
   }
 
   if(!gameState->initialized)
@@ -681,6 +1393,9 @@ EXPORT_FN void update_game(GameState* gameStateIn,
     renderData->uiCamera.position.x = 160;
     renderData->uiCamera.position.y = -90;
 
+    // Drawn at the native Resolution, the Renderer scales it up to the Screen
+    renderData->renderTargetSize = {WORLD_WIDTH, WORLD_HEIGHT};
+
     // Player
     {
       Player& player = gameState->player;
@@ -691,7 +1406,7 @@ EXPORT_FN void update_game(GameState* gameStateIn,
 
     // Tileset
     {
-      IVec2 tilesPosition = {48, 0};
+      IVec2 tilesPosition = get_sprite(SPRITE_TILESET).atlasOffset;
 
       for(int y = 0; y < 5; y++)
       {
@@ -719,6 +1434,7 @@ EXPORT_FN void update_game(GameState* gameStateIn,
       gameState->keyMappings[MOUSE_RIGHT].keys.add(KEY_MOUSE_RIGHT);
       gameState->keyMappings[JUMP].keys.add(KEY_SPACE);
       gameState->keyMappings[PAUSE].keys.add(KEY_ESCAPE);
+      gameState->keyMappings[REWIND].keys.add(KEY_R);
     }
 
     // Solids
@@ -740,6 +1456,8 @@ EXPORT_FN void update_game(GameState* gameStateIn,
       gameState->solids.add(solid);
     }
 
+    autotile_all_tiles();
+
     gameState->initialized = true;
   }
 
@@ -749,6 +1467,18 @@ EXPORT_FN void update_game(GameState* gameStateIn,
     while(gameState->updateTimer >= UPDATE_DELAY)
     {
       gameState->updateTimer -= UPDATE_DELAY;
+
+      // The Replay replaces the Input of the Platform, one recorded tick per simulated tick
+      if(replayState->mode == REPLAY_MODE_PLAY && !play_replay_tick())
+      {
+        gameState->updateTimer = 0.0f;
+        break;
+      }
+      if(replayState->mode == REPLAY_MODE_RECORD)
+      {
+        record_replay_tick();
+      }
+
       update_ui();
       simulate();
 
@@ -781,7 +1511,7 @@ EXPORT_FN void update_game(GameState* gameStateIn,
     for(int uiTextIdx = 0; uiTextIdx < uiState->uiTexts.count; uiTextIdx++)
     {
       UIText& uiText = uiState->uiTexts[uiTextIdx];
-      draw_ui_text(uiText.text, uiText.pos, uiText.textData);
+      draw_ui_text(&uiState->textBuffer[uiText.textOffset], uiText.pos, uiText.textData);
     }
   }
 
@@ -810,30 +1540,33 @@ EXPORT_FN void update_game(GameState* gameStateIn,
                 });
   }
 
-  // Drawing Tileset
+  // Drawing Tileset, the Renderer draws the Tile Map in one go, 
+  // it is only written when the Tiles change
   {
-    for(int y = 0; y < WORLD_GRID.y; y++)
+    renderData->tileMaterialIdx = get_material_idx({.color  = COLOR_WHITE});
+
+    if(renderData->tileGeneration != gameState->tileGeneration)
     {
-      for(int x = 0; x < WORLD_GRID.x; x++)
+      SM_ASSERT(gameState->tileCoords.count <= MAX_TILE_TYPES, "Too many Tile Types");
+      renderData->tileMapSize = WORLD_GRID;
+      renderData->tileSize = TILESIZE;
+      renderData->tileLayer = get_layer(LAYER_GAME, 0);
+      renderData->tileTypeCount = gameState->tileCoords.count;
+      memcpy(renderData->tileAtlasOffsets, gameState->tileCoords.elements, 
+             sizeof(IVec2) * gameState->tileCoords.count);
+
+      for(int y = 0; y < WORLD_GRID.y; y++)
       {
-        Tile* tile = get_tile(x, y);
-
-        if(!tile->isVisible)
+        for(int x = 0; x < WORLD_GRID.x; x++)
         {
-          continue;
-        }
+          Tile* tile = get_tile(x, y);
 
-                // Draw Tile
-        Transform transform = {};
-        // Draw the Tile around the center
-        transform.materialIdx = get_material_idx({.color  = COLOR_WHITE});
-        transform.pos = {x * (float)TILESIZE, y * (float)TILESIZE};
-        transform.size = {8, 8};
-        transform.spriteSize = {8, 8};
-        transform.atlasOffset = gameState->tileCoords[tile->neighbourMask];
-        transform.layer = get_layer(LAYER_GAME, 0);
-        draw_quad(transform);
+          // Type 0 is an empty Tile
+          set_tile_map_tile(x, y, tile->isVisible? tile->neighbourMask + 1 : 0);
+        }
       }
+
+      renderData->tileGeneration = gameState->tileGeneration;
     }
   }
 }
\ No newline at end of file
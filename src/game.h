@@ -15,6 +15,26 @@ constexpr int WORLD_WIDTH = 320;
 constexpr int WORLD_HEIGHT = 180;
 constexpr int TILESIZE = 8;
 constexpr IVec2 WORLD_GRID = {WORLD_WIDTH / TILESIZE, WORLD_HEIGHT / TILESIZE};
+constexpr int MAX_SOLIDS = 2048;
+constexpr int MAX_ACTORS = 10000;
+static_assert(WORLD_GRID.x * WORLD_GRID.y <= MAX_TILE_MAP_TILES, "Tile Map doesn't fit the World");
+
+// Collision Bitboard, one bit per Tile, row major, 64 Tiles per word
+constexpr int TILE_ROW_WORDS = (WORLD_GRID.x + 63) / 64;
+
+// Broad Phase for Solids, Cells are 32x32 Pixels, hashed into Buckets
+constexpr int SOLID_GRID_CELL_SHIFT = 5;
+constexpr int SOLID_GRID_BUCKET_COUNT = 1024; // Has to be a power of two
+constexpr int MAX_SOLID_GRID_ENTRIES = MAX_SOLIDS * 4;
+
+// Snapshots of the Level, one per tick, stored back to back in a ring buffer
+constexpr int MAX_SNAPSHOTS = UPDATES_PER_SECOND * 10;
+constexpr int SNAPSHOT_BUFFER_SIZE = MB(64);
+
+// Recorded Input, a few Bytes per tick
+constexpr int REPLAY_BUFFER_SIZE = MB(16);
+constexpr int REPLAY_MAGIC = 0x4c505253; // "SRPL"
+constexpr int REPLAY_VERSION = 1;
 
 // #############################################################################
 //                           Game Structs
@@ -31,6 +51,7 @@ enum GameInputType
   MOUSE_RIGHT,
 
   PAUSE,
+  REWIND,
 
   GAME_INPUT_COUNT
 };
@@ -59,14 +80,41 @@ struct Player
 {
   IVec2 pos;
   IVec2 prevPos;
+  Vec2 remainder;
   Vec2 speed;
   Vec2 solidSpeed;
+  bool grounded;
   int renderOptions;
   float runAnimTime;
   PlayerAnimState animationState;
   SpriteID animationSprites[PLAYER_ANIM_COUNT];
 };
 
+enum ActorFlagBits
+{
+  ACTOR_FLAG_GRAVITY = BIT(0),
+  ACTOR_FLAG_BOUNCE = BIT(1), // Reverses speedX instead of stopping on collision
+};
+typedef int ActorFlags;
+
+// Structure of Arrays, every pass of update_actors() only touches the arrays it needs,
+// Actors move like the Player, in whole Pixels and stop at Solids and Tiles
+struct Actors
+{
+  int count;
+  int posX[MAX_ACTORS];
+  int posY[MAX_ACTORS];
+  int prevPosX[MAX_ACTORS];
+  int prevPosY[MAX_ACTORS];
+  int sizeX[MAX_ACTORS];
+  int sizeY[MAX_ACTORS];
+  float remainderX[MAX_ACTORS];
+  float remainderY[MAX_ACTORS];
+  float speedX[MAX_ACTORS]; // Pixels per tick
+  float speedY[MAX_ACTORS];
+  ActorFlags flags[MAX_ACTORS];
+};
+
 struct Solid
 {
   SpriteID spriteID;
@@ -78,6 +126,89 @@ struct Solid
   Array<IVec2, 2> keyframes;
 };
 
+struct SolidGrid
+{
+  int entryCount;
+
+  // Cached when the Grid is built, saves the get_sprite() call per query
+  IRect solidRects[MAX_SOLIDS];
+
+  // Solid indices sorted by Bucket, Bucket b owns the 
+  // entries from bucketStart[b] to bucketStart[b + 1] - 1
+  int bucketStart[SOLID_GRID_BUCKET_COUNT + 1];
+  int entries[MAX_SOLID_GRID_ENTRIES];
+};
+
+struct Snapshot
+{
+  int tick;
+  int offset;
+  int size;
+};
+
+struct SnapshotState
+{
+  // Ring of Snapshots, oldest first
+  int firstSnapshotIdx;
+  int snapshotCount;
+  Snapshot snapshots[MAX_SNAPSHOTS];
+  char* buffer;
+
+  // Taken when entering the Level, restored when the Player dies
+  int checkpointSize;
+  char* checkpoint;
+};
+
+enum ReplayMode
+{
+  REPLAY_MODE_OFF,
+  REPLAY_MODE_RECORD,
+  REPLAY_MODE_PLAY,
+};
+
+struct ReplayHeader
+{
+  int magic;
+  int version;
+  IVec2 screenSize;
+  int startState; // GameStateID
+};
+
+// Every tick starts with the flags and the number of Key records, followed by the
+// Keys that changed, then the Mouse and the Screen Size if they changed
+enum ReplayTickBits
+{
+  REPLAY_TICK_MOUSE = BIT(0),
+  REPLAY_TICK_SCREEN_SIZE = BIT(1),
+};
+
+struct ReplayKey
+{
+  unsigned char keyCode;
+  unsigned char isDown;
+  unsigned char justPressed;
+  unsigned char justReleased;
+  unsigned char halfTransitionCount;
+};
+
+struct ReplayState
+{
+  ReplayMode mode;
+  bool finished;
+  bool corrupt; // Bad Header or the Log ends in the middle of a tick
+  int tickCount;
+
+  // Written while recording, read while playing, starts with the ReplayHeader
+  int size;
+  int cursor;
+  char* buffer;
+
+  // Last recorded values, only changes go into the Log
+  IVec2 mousePos;
+  IVec2 mousePosWorld;
+  IVec2 screenSize;
+};
+
 enum GameStateID
 {
   GAME_STATE_MAIN_MENU,
@@ -89,12 +220,25 @@ struct GameState
   GameStateID state;
   float updateTimer;
   bool initialized = false;
+  int tick;
 
   Player player;
-  Array<Solid, 20> solids;
+  Actors actors;
+  Array<Solid, MAX_SOLIDS> solids;
+  SolidGrid solidGrid;
   
   Array<IVec2, 21> tileCoords;
   Tile worldGrid[WORLD_GRID.x][WORLD_GRID.y];
+
+  // Mirrors Tile::isVisible, only written through set_tile_visible()
+  uint64_t tileBits[WORLD_GRID.y][TILE_ROW_WORDS];
+
+  // Tiles that changed visibility since the last autotile_dirty_tiles()
+  uint64_t dirtyTileBits[WORLD_GRID.y][TILE_ROW_WORDS];
+
+  // Incremented whenever Tiles or their masks change, the cached Tile Layer compares it
+  int tileGeneration;
+
   KeyMapping keyMappings[GAME_INPUT_COUNT];
 };
 
@@ -102,6 +246,8 @@ struct GameState
 //                           Game Globals
 // #############################################################################
 static GameState* gameState;
+static SnapshotState* snapshotState;
+static ReplayState* replayState;
 
 // #############################################################################
 //                           Game Functions (Exposed)
@@ -113,5 +259,7 @@ extern "C"
                              Input* inputIn, 
                              SoundState* soundStateIn,
                              UIState* uiStateIn,
+                             SnapshotState* snapshotStateIn,
+                             ReplayState* replayStateIn,
                              float dt);
 }
\ No newline at end of file
@@ -1,42 +1,110 @@
 #include "gl_renderer.h"
 #include "render_interface.h"
 
-// To Load PNG Files
+// To Load the Texture Atlas, written by asset_baker.cpp
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-// To Load TTF Files
-#include <ft2build.h>
-#include FT_FREETYPE_H
-
+// Texture Hot Reloading decodes on a Thread
+#include <thread>
+#include <atomic>
 
 // #############################################################################
 //                           OpenGL Constants
 // #############################################################################
-const char* TEXTURE_PATH = "assets/textures/TEXTURE_ATLAS.png";
-
+// How often the Texture Reload Thread checks the Timestamp of the Atlas
+constexpr int TEXTURE_RELOAD_POLL_MS = 100;
+
+// Format of the Transforms in the Storage Buffers, see shader_header.h
+#ifdef PACKED_TRANSFORMS
+typedef PackedTransform GPUTransform;
+#else
+typedef Transform GPUTransform;
+#endif
+
+// Frames the CPU writes ahead of the GPU, each one gets its own Region of the Transform Ring
+constexpr int TRANSFORM_RING_FRAMES = 3;
+
+// In front of every Shader, part of the Key of the Program Cache
+const char* SHADER_PREAMBLE =
+  "#version 430 core\r\n"
+#ifdef PACKED_TRANSFORMS
+  "#define PACKED_TRANSFORMS\r\n"
+#endif
+  ;
+
+// Linked Programs, written next to their Shaders, see gl_create_program()
+constexpr int PROGRAM_CACHE_MAGIC = 0x47525050; // "PPRG"
+constexpr int PROGRAM_CACHE_VERSION = 1;
 
 // #############################################################################
 //                           OpenGL Structs
 // #############################################################################
+// The File starts with this, followed by binarySize Bytes from glGetProgramBinary()
+struct ProgramCacheHeader
+{
+  int magic;
+  int version;
+  uint64_t programHash; // See gl_get_program_hash()
+  GLenum binaryFormat;
+  int binarySize;
+};
+
 struct GLContext
 {
   GLuint programID;
+  GLuint tileMapProgramID;
   GLuint textureID;
   GLuint transformSBOID;
   GLuint materialSBOID;
   GLuint screenSizeID;
   GLuint orthoProjectionID;
+  GLuint transformOffsetID;
+  GLuint tileOrthoProjectionID;
+  GLuint tileMapPosID;
+  GLuint tileMapSizeID;
+  GLuint tileLayerID;
+  GLuint tileSizeID;
+  GLuint tileMaterialIdxID;
+  GLuint tileAtlasOffsetsID;
   GLuint fontAtlasID;
+  GLuint texturePBOID;
+  IVec2 textureSize;
+  GLuint tileMapTextureID;
+  IVec2 tileMapSize; // What was uploaded, see gl_upload_tile_map()
+
+  // The Game and UI are drawn into it, see gl_present_render_target()
+  GLuint renderTargetFBOID;
+  GLuint renderTargetColorID;
+  GLuint renderTargetDepthID;
+  IVec2 renderTargetSize;
+
+  // Transform Ring, see gl_create_transform_ring(), the Capacity is per Region
+  bool hasBufferStorage;
+  char* transformRing;
+  int transformRegionCapacity;
+  int transformRegion;
+  GLsync transformFences[TRANSFORM_RING_FRAMES];
 
-  long long textureTimestamp;
   long long shaderTimestamp;
 };
 
+// Filled by texture_reload_thread(), only the Render Thread touches 
+// it again once ready is set, until it clears ready after the upload
+struct TextureReload
+{
+  std::atomic<bool> ready;
+  long long timestamp;
+  int width;
+  int height;
+  unsigned char* pixels;
+};
+
 // #############################################################################
 //                           OpenGL Globals
 // #############################################################################
 static GLContext glContext;
+static TextureReload textureReload;
 
 // #############################################################################
 //                           OpenGL Functions
@@ -56,25 +124,11 @@ static void APIENTRY gl_debug_callback(GLenum source, GLenum type, GLuint id, GL
   }
 }
 
-GLuint gl_create_shader(int shaderType, char* shaderPath, BumpAllocator* transientStorage)
+GLuint gl_create_shader(int shaderType, char* shaderPath, char* shaderHeader, char* shaderSource)
 {
-  int fileSize = 0;
-  char* shaderHeader = read_file("src/shader_header.h", &fileSize, transientStorage);
-  char* shaderSource = read_file(shaderPath, &fileSize, transientStorage);
-  if(!shaderHeader)
-  {
-    SM_ASSERT(false, "Failed to load shader_header.h");
-    return 0;
-  }
-  if(!shaderSource)
-  {
-    SM_ASSERT(false, "Failed to load shader: %s",shaderPath);
-    return 0;
-  }
-
   char* shaderSources[] =
   {
-    "#version 430 core\r\n",
+    (char*)SHADER_PREAMBLE,
     shaderHeader,
     shaderSource
   };
@@ -100,79 +154,346 @@ GLuint gl_create_shader(int shaderType, char* shaderPath, BumpAllocator* transie
   return shaderID;
 }
 
-void load_font(char* filePath, int fontSize)
+// Changes with the Sources and the Driver, Binaries only load on the Driver that wrote them
+uint64_t gl_get_program_hash(char* shaderHeader, char* vertSource, char* fragSource)
 {
-  FT_Library fontLibrary;
-  FT_Init_FreeType(&fontLibrary);
+  char* keyParts[] =
+  {
+    (char*)SHADER_PREAMBLE,
+    shaderHeader,
+    vertSource,
+    fragSource,
+    (char*)glGetString(GL_VENDOR),
+    (char*)glGetString(GL_RENDERER),
+    (char*)glGetString(GL_VERSION)
+  };
 
-  FT_Face fontFace;
-  FT_New_Face(fontLibrary, filePath, 0, &fontFace);
-  FT_Set_Pixel_Sizes(fontFace, 0, fontSize);
+  uint64_t hash = hash_bytes(nullptr, 0); // The Offset Basis
+  for(int partIdx = 0; partIdx < ArraySize(keyParts); partIdx++)
+  {
+    // With the Terminator, so moving Text between Parts changes the Hash
+    char* part = keyParts[partIdx]? keyParts[partIdx]: (char*)"";
+    hash = hash_bytes(part, strlen(part) + 1, hash);
+  }
 
-  int padding = 2;
-  int row = 0;
-  int col = padding;
+  return hash;
+}
 
-  const int textureWidth = 512;
-  char textureBuffer[textureWidth  * textureWidth];
-  for (FT_ULong glyphIdx = 32; glyphIdx < 127; ++glyphIdx)
+// glProgramBinary() raises an Error for Formats the Driver doesn't know
+bool gl_supports_binary_format(GLenum binaryFormat, BumpAllocator* transientStorage)
+{
+  int formatCount = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+  if(formatCount <= 0)
   {
-    FT_UInt glyphIndex = FT_Get_Char_Index(fontFace, glyphIdx);
-    FT_Load_Glyph(fontFace, glyphIndex, FT_LOAD_DEFAULT);
-    FT_Error error = FT_Render_Glyph(fontFace->glyph, FT_RENDER_MODE_NORMAL);
+    return false;
+  }
 
-    if (col + fontFace->glyph->bitmap.width + padding >= 512)
+  GLint* formats = (GLint*)bump_alloc(transientStorage, sizeof(GLint) * formatCount);
+  if(!formats)
+  {
+    return false;
+  }
+  glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats);
+
+  for(int formatIdx = 0; formatIdx < formatCount; formatIdx++)
+  {
+    if((GLenum)formats[formatIdx] == binaryFormat)
     {
-      col = padding;
-      row += fontSize;
+      return true;
     }
+  }
+
+  return false;
+}
+
+// Returns 0 if there is no Binary for the Hash or the Driver rejects it
+GLuint gl_load_program_binary(char* cachePath, uint64_t programHash, 
+                              BumpAllocator* transientStorage)
+{
+  long long fileSize = 0;
+  char* data = platform_map_file(cachePath, &fileSize);
+  if(!data)
+  {
+    return 0;
+  }
 
-    // Font Height
-    renderData->fontHeight = 
-      max((fontFace->size->metrics.ascender - fontFace->size->metrics.descender) >> 6, 
-          renderData->fontHeight);
+  GLuint programID = 0;
+  ProgramCacheHeader* header = (ProgramCacheHeader*)data;
+  if(fileSize >= sizeof(ProgramCacheHeader) &&
+     header->magic == PROGRAM_CACHE_MAGIC &&
+     header->version == PROGRAM_CACHE_VERSION &&
+     header->programHash == programHash &&
+     header->binarySize > 0 &&
+     fileSize == sizeof(ProgramCacheHeader) + header->binarySize &&
+     gl_supports_binary_format(header->binaryFormat, transientStorage))
+  {
+    programID = glCreateProgram();
+    glProgramBinary(programID, header->binaryFormat, 
+                    data + sizeof(ProgramCacheHeader), header->binarySize);
 
-    for (unsigned int y = 0; y < fontFace->glyph->bitmap.rows; ++y)
+    int programSuccess;
+    glGetProgramiv(programID, GL_LINK_STATUS, &programSuccess);
+    if(!programSuccess)
     {
-      for (unsigned int x = 0; x < fontFace->glyph->bitmap.width; ++x)
-      {
-        textureBuffer[(row + y) * textureWidth + col + x] =
-            fontFace->glyph->bitmap.buffer[y * fontFace->glyph->bitmap.width + x];
-      }
+      SM_WARN("Cached Program %s was rejected, compiling it", cachePath);
+      glDeleteProgram(programID);
+      programID = 0;
     }
+  }
+
+  platform_unmap_file(data, fileSize);
+
+  return programID;
+}
+
+// Drivers without Binary Formats report a Length of 0, nothing is written then
+void gl_save_program_binary(GLuint programID, char* cachePath, uint64_t programHash,
+                            BumpAllocator* transientStorage)
+{
+  int binarySize = 0;
+  glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+  if(binarySize <= 0)
+  {
+    return;
+  }
+
+  char* buffer = bump_alloc(transientStorage, sizeof(ProgramCacheHeader) + binarySize);
+  if(!buffer)
+  {
+    return;
+  }
+
+  ProgramCacheHeader* header = (ProgramCacheHeader*)buffer;
+  *header = {};
+  header->magic = PROGRAM_CACHE_MAGIC;
+  header->version = PROGRAM_CACHE_VERSION;
+  header->programHash = programHash;
+
+  GLsizei length = 0;
+  glGetProgramBinary(programID, binarySize, &length, &header->binaryFormat, 
+                     buffer + sizeof(ProgramCacheHeader));
+  if(length <= 0)
+  {
+    return;
+  }
+  header->binarySize = length;
+
+  write_file(cachePath, buffer, sizeof(ProgramCacheHeader) + length);
+}
+
+// Loads the Program from the Cache if the Sources and the Driver are the same,
+// otherwise compiles and links the Shaders and caches them, returns 0 on failure
+GLuint gl_create_program(char* vertShaderPath, char* fragShaderPath, char* cachePath,
+                         BumpAllocator* transientStorage)
+{
+  int fileSize = 0;
+  char* shaderHeader = read_file("src/shader_header.h", &fileSize, transientStorage);
+  char* vertSource = read_file(vertShaderPath, &fileSize, transientStorage);
+  char* fragSource = read_file(fragShaderPath, &fileSize, transientStorage);
+  if(!shaderHeader)
+  {
+    SM_ASSERT(false, "Failed to load shader_header.h");
+    return 0;
+  }
+  if(!vertSource || !fragSource)
+  {
+    SM_ASSERT(false, "Failed to load shader: %s", vertSource? fragShaderPath: vertShaderPath);
+    return 0;
+  }
+
+  uint64_t programHash = gl_get_program_hash(shaderHeader, vertSource, fragSource);
+  GLuint cachedProgramID = gl_load_program_binary(cachePath, programHash, transientStorage);
+  if(cachedProgramID)
+  {
+    return cachedProgramID;
+  }
+
+  GLuint vertShaderID = gl_create_shader(GL_VERTEX_SHADER, vertShaderPath, 
+                                         shaderHeader, vertSource);
+  GLuint fragShaderID = gl_create_shader(GL_FRAGMENT_SHADER, fragShaderPath, 
+                                         shaderHeader, fragSource);
+  if(!vertShaderID || !fragShaderID)
+  {
+    SM_ASSERT(false, "Failed to create Shaders")
+    glDeleteShader(vertShaderID);
+    glDeleteShader(fragShaderID);
+    return 0;
+  }
+
+  GLuint programID = glCreateProgram();
+  glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  glAttachShader(programID, vertShaderID);
+  glAttachShader(programID, fragShaderID);
+  glLinkProgram(programID);
+
+  glDetachShader(programID, vertShaderID);
+  glDetachShader(programID, fragShaderID);
+  glDeleteShader(vertShaderID);
+  glDeleteShader(fragShaderID);
 
-    Glyph* glyph = &renderData->glyphs[glyphIdx];
-    glyph->textureCoords = {col, row};
-    glyph->size = 
-    { 
-      (int)fontFace->glyph->bitmap.width, 
-      (int)fontFace->glyph->bitmap.rows
-    };
-    glyph->advance = 
+  // Validate if program works
+  {
+    int programSuccess;
+    char programInfoLog[512];
+    glGetProgramiv(programID, GL_LINK_STATUS, &programSuccess);
+
+    if(!programSuccess)
     {
-      (float)(fontFace->glyph->advance.x >> 6), 
-      (float)(fontFace->glyph->advance.y >> 6)
-    };
-    glyph->offset =
+      glGetProgramInfoLog(programID, 512, 0, programInfoLog);
+
+      SM_ASSERT(0, "Failed to link program: %s", programInfoLog);
+      glDeleteProgram(programID);
+      return 0;
+    }
+  }
+
+  gl_save_program_binary(programID, cachePath, programHash, transientStorage);
+
+  return programID;
+}
+
+long long gl_get_shader_timestamp()
+{
+  long long timestamp = get_timestamp("assets/shaders/quad.vert");
+  timestamp = max(timestamp, get_timestamp("assets/shaders/quad.frag"));
+  timestamp = max(timestamp, get_timestamp("assets/shaders/tilemap.vert"));
+  timestamp = max(timestamp, get_timestamp("assets/shaders/tilemap.frag"));
+  return timestamp;
+}
+
+// Builds both Programs, the old ones are only replaced if both succeed,
+// used by gl_init() and the Shader Hot Reloading
+bool gl_create_programs(BumpAllocator* transientStorage)
+{
+  long long shaderTimestamp = gl_get_shader_timestamp();
+
+  GLuint programID = gl_create_program("assets/shaders/quad.vert", 
+                                       "assets/shaders/quad.frag", 
+                                       "assets/shaders/quad.program", transientStorage);
+  GLuint tileMapProgramID = gl_create_program("assets/shaders/tilemap.vert", 
+                                              "assets/shaders/tilemap.frag", 
+                                              "assets/shaders/tilemap.program", transientStorage);
+  if(!programID || !tileMapProgramID)
+  {
+    glDeleteProgram(programID);
+    glDeleteProgram(tileMapProgramID);
+    return false;
+  }
+
+  glDeleteProgram(glContext.programID);
+  glDeleteProgram(glContext.tileMapProgramID);
+  glContext.programID = programID;
+  glContext.tileMapProgramID = tileMapProgramID;
+  glContext.shaderTimestamp = shaderTimestamp;
+
+  // Uniforms
+  {
+    glContext.screenSizeID = glGetUniformLocation(programID, "screenSize");
+    glContext.orthoProjectionID = glGetUniformLocation(programID, "orthoProjection");
+    glContext.transformOffsetID = glGetUniformLocation(programID, "transformOffset");
+
+    glContext.tileOrthoProjectionID = glGetUniformLocation(tileMapProgramID, "orthoProjection");
+    glContext.tileMapPosID = glGetUniformLocation(tileMapProgramID, "tileMapPos");
+    glContext.tileMapSizeID = glGetUniformLocation(tileMapProgramID, "tileMapSize");
+    glContext.tileLayerID = glGetUniformLocation(tileMapProgramID, "tileLayer");
+    glContext.tileSizeID = glGetUniformLocation(tileMapProgramID, "tileSize");
+    glContext.tileMaterialIdxID = glGetUniformLocation(tileMapProgramID, "tileMaterialIdx");
+    glContext.tileAtlasOffsetsID = glGetUniformLocation(tileMapProgramID, "tileAtlasOffsets");
+  }
+
+  glUseProgram(programID);
+
+  return true;
+}
+
+// Fills the Font Cache from a File written by font_baker.cpp, only if it was baked
+// from the same TTF File and size, otherwise the Glyphs are rasterized with FreeType
+bool load_baked_font(char* bakedFontPath)
+{
+  FontCache* fontCache = &renderData->fontCache;
+
+  long long fileSize = 0;
+  char* data = platform_map_file(bakedFontPath, &fileSize);
+  if(!data)
+  {
+    return false;
+  }
+
+  bool result = false;
+  BakedFontHeader* header = (BakedFontHeader*)data;
+  long long expectedSize = 0;
+  if(fileSize >= sizeof(BakedFontHeader) &&
+     header->magic == BAKED_FONT_MAGIC &&
+     header->version == BAKED_FONT_VERSION &&
+     header->fontSize == fontCache->fontSize &&
+     header->glyphHeight >= header->fontHeight && header->glyphHeight < FONT_ATLAS_SIZE &&
+     header->atlasSize == FONT_ATLAS_SIZE &&
+     header->glyphCount >= 0 && header->glyphCount <= MAX_CACHED_GLYPHS &&
+     header->shelfCount >= 0 && header->shelfCount <= MAX_GLYPH_SHELVES)
+  {
+    expectedSize = sizeof(BakedFontHeader) + 
+                   sizeof(CachedGlyph) * header->glyphCount +
+                   sizeof(GlyphShelf) * header->shelfCount +
+                   FONT_ATLAS_SIZE * FONT_ATLAS_SIZE;
+  }
+
+  if(expectedSize && fileSize == expectedSize)
+  {
+    long long ttfSize = 0;
+    char* ttf = platform_map_file(fontCache->fontPath, &ttfSize);
+    if(ttf && hash_bytes(ttf, ttfSize) == header->ttfHash)
     {
-      (float)fontFace->glyph->bitmap_left,
-      (float)fontFace->glyph->bitmap_top,
-    };
+      char* glyphs = data + sizeof(BakedFontHeader);
+      char* shelves = glyphs + sizeof(CachedGlyph) * header->glyphCount;
+      char* atlas = shelves + sizeof(GlyphShelf) * header->shelfCount;
+
+      memcpy(fontCache->glyphs.elements, glyphs, sizeof(CachedGlyph) * header->glyphCount);
+      fontCache->glyphs.count = header->glyphCount;
+      memcpy(fontCache->shelves.elements, shelves, sizeof(GlyphShelf) * header->shelfCount);
+      fontCache->shelves.count = header->shelfCount;
+      memcpy(fontCache->atlas, atlas, FONT_ATLAS_SIZE * FONT_ATLAS_SIZE);
+      fontCache->fontHeight = header->fontHeight;
+      fontCache->glyphHeight = header->glyphHeight;
+      rebuild_glyph_slots(fontCache);
+
+      result = true;
+    }
 
-    col += fontFace->glyph->bitmap.width + padding;
+    if(ttf)
+    {
+      platform_unmap_file(ttf, ttfSize);
+    }
   }
 
-  FT_Done_Face(fontFace);
-  FT_Done_FreeType(fontLibrary);
+  platform_unmap_file(data, fileSize);
+
+  return result;
+}
+
+// Uses the baked Font if it is up to date, otherwise the Face is opened right away,
+// Glyphs that are not in the Atlas yet are rasterized on demand either way, see font.h
+void load_font(char* filePath, int fontSize, char* bakedFontPath)
+{
+  FontCache* fontCache = &renderData->fontCache;
+  SM_ASSERT(strlen(filePath) < sizeof(fontCache->fontPath), "Font Path too long: %s", filePath);
+  strncpy(fontCache->fontPath, filePath, sizeof(fontCache->fontPath) - 1);
+  fontCache->fontSize = fontSize;
+
+  if(!load_baked_font(bakedFontPath))
+  {
+    SM_WARN("Baked Font %s missing or out of date, using FreeType", bakedFontPath);
+    load_font_face(fontCache);
+  }
 
-  // Upload OpenGL Texture
+  // Upload OpenGL Texture, holds the baked Glyphs, if there are any
   {
     glGenTextures(1, (GLuint*)&glContext.fontAtlasID);
     glActiveTexture(GL_TEXTURE1); // Bound to binding = 1, see quad.frag
     glBindTexture(GL_TEXTURE_2D, glContext.fontAtlasID);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, textureWidth, textureWidth, 0, 
-                 GL_RED, GL_UNSIGNED_BYTE, (char*)textureBuffer);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, FONT_ATLAS_SIZE, FONT_ATLAS_SIZE, 0, 
+                 GL_RED, GL_UNSIGNED_BYTE, fontCache->atlas);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -181,53 +502,349 @@ void load_font(char* filePath, int fontSize)
   }
 }
 
+// Only the part of the Atlas that changed since the last frame is uploaded
+void gl_upload_font_atlas()
+{
+  FontCache* fontCache = &renderData->fontCache;
+  IRect dirtyRect = fontCache->dirtyRect;
+  if(!dirtyRect.size.x || !dirtyRect.size.y)
+  {
+    return;
+  }
 
-bool gl_init(BumpAllocator* transientStorage)
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, glContext.fontAtlasID);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, FONT_ATLAS_SIZE);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyRect.pos.x, dirtyRect.pos.y, 
+                  dirtyRect.size.x, dirtyRect.size.y, GL_RED, GL_UNSIGNED_BYTE,
+                  &fontCache->atlas[dirtyRect.pos.y * FONT_ATLAS_SIZE + dirtyRect.pos.x]);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  fontCache->dirtyRect = {};
+}
+
+// Only the Tiles that changed since the last frame are uploaded, 
+// all of them if the size of the Tile Map changed
+void gl_upload_tile_map()
 {
-  load_gl_functions();
+  IVec2 mapSize = renderData->tileMapSize;
+  IRect dirtyRect = renderData->tileMapDirtyRect;
+  bool resized = glContext.tileMapSize != mapSize;
+  if(!mapSize.x || !mapSize.y || (!resized && (!dirtyRect.size.x || !dirtyRect.size.y)))
+  {
+    return;
+  }
 
-  glDebugMessageCallback(&gl_debug_callback, nullptr);
-  glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-  glEnable(GL_DEBUG_OUTPUT);
+  glActiveTexture(GL_TEXTURE2);
+  glBindTexture(GL_TEXTURE_2D, glContext.tileMapTextureID);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  if(resized)
+  {
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, mapSize.x, mapSize.y, 0, 
+                 GL_RED_INTEGER, GL_UNSIGNED_BYTE, renderData->tileMap);
+    glContext.tileMapSize = mapSize;
+  }
+  else
+  {
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, mapSize.x);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyRect.pos.x, dirtyRect.pos.y, 
+                    dirtyRect.size.x, dirtyRect.size.y, GL_RED_INTEGER, GL_UNSIGNED_BYTE,
+                    &renderData->tileMap[dirtyRect.pos.y * mapSize.x + dirtyRect.pos.x]);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
-  GLuint vertShaderID = gl_create_shader(GL_VERTEX_SHADER, 
-                                         "assets/shaders/quad.vert", transientStorage);
-  GLuint fragShaderID = gl_create_shader(GL_FRAGMENT_SHADER, 
-                                         "assets/shaders/quad.frag", transientStorage);
-  if(!vertShaderID || !fragShaderID)
+  renderData->tileMapDirtyRect = {};
+}
+
+// Keeps the Framebuffer, only the Storage of its Renderbuffers changes
+void gl_resize_render_target(IVec2 size)
+{
+  glBindRenderbuffer(GL_RENDERBUFFER, glContext.renderTargetColorID);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_SRGB8_ALPHA8, size.x, size.y);
+  glBindRenderbuffer(GL_RENDERBUFFER, glContext.renderTargetDepthID);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size.x, size.y);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, glContext.renderTargetFBOID);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, glContext.renderTargetColorID);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                            GL_RENDERBUFFER, glContext.renderTargetDepthID);
+  SM_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE,
+            "Render Target incomplete, %dx%d", size.x, size.y);
+
+  glContext.renderTargetSize = size;
+}
+
+// One Blit to the Screen, Nearest for integer Scales, so the Pixels stay sharp,
+// the letterbox is cleared to black
+void gl_present_render_target()
+{
+  IVec2 targetSize = glContext.renderTargetSize;
+  IRect viewport = get_render_target_viewport();
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, glContext.renderTargetFBOID);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glViewport(0, 0, input->screenSize.x, input->screenSize.y);
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT);
+
+  // OpenGL has the Origin at the bottom left
+  int bottom = input->screenSize.y - viewport.pos.y - viewport.size.y;
+  bool integerScale = viewport.size.x % targetSize.x == 0 && viewport.size.y % targetSize.y == 0;
+  glBlitFramebuffer(0, 0, targetSize.x, targetSize.y,
+                    viewport.pos.x, bottom, viewport.pos.x + viewport.size.x, bottom + viewport.size.y,
+                    GL_COLOR_BUFFER_BIT, integerScale? GL_NEAREST : GL_LINEAR);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void gl_draw_instances(int count)
+{
+  if(count > 0)
   {
-    SM_ASSERT(false, "Failed to create Shaders")
-    return false;
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+    renderData->instanceCount += count;
+    renderData->drawCallCount++;
   }
+}
 
-  long long timestampVert = get_timestamp("assets/shaders/quad.vert");
-  long long timestampFrag = get_timestamp("assets/shaders/quad.frag");
-  glContext.shaderTimestamp = max(timestampVert, timestampFrag);
+// Core since 4.4, before that only with GL_ARB_buffer_storage
+bool gl_supports_buffer_storage()
+{
+  int majorVersion = 0;
+  int minorVersion = 0;
+  glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+  glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+  if(majorVersion > 4 || (majorVersion == 4 && minorVersion >= 4))
+  {
+    return true;
+  }
 
-  glContext.programID = glCreateProgram();
-  glAttachShader(glContext.programID, vertShaderID);
-  glAttachShader(glContext.programID, fragShaderID);
-  glLinkProgram(glContext.programID);
+  int extensionCount = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+  for(int extensionIdx = 0; extensionIdx < extensionCount; extensionIdx++)
+  {
+    char* extension = (char*)glGetStringi(GL_EXTENSIONS, extensionIdx);
+    if(extension && strcmp(extension, "GL_ARB_buffer_storage") == 0)
+    {
+      return true;
+    }
+  }
 
-  // Validate if program works
+  return false;
+}
+
+// Three Regions, the CPU writes one while the GPU still reads the other two, a Fence
+// per Region says when it's free again. Persistently mapped if the Driver has 
+// glBufferStorage, otherwise each Region is mapped unsynchronized for its Frame
+void gl_create_transform_ring(int regionCapacity)
+{
+  // Nothing may still read from the old Ring
+  if(glContext.transformSBOID)
   {
-    int programSuccess;
-    char programInfoLog[512];
-    glGetProgramiv(glContext.programID, GL_LINK_STATUS, &programSuccess);
+    glFinish();
+    for(int regionIdx = 0; regionIdx < TRANSFORM_RING_FRAMES; regionIdx++)
+    {
+      if(glContext.transformFences[regionIdx])
+      {
+        glDeleteSync(glContext.transformFences[regionIdx]);
+        glContext.transformFences[regionIdx] = nullptr;
+      }
+    }
+    glDeleteBuffers(1, &glContext.transformSBOID);
+  }
 
-    if(!programSuccess)
+  // Buffer Storage is immutable, so the Ring grows by making a new Buffer
+  glGenBuffers(1, &glContext.transformSBOID);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glContext.transformSBOID);
+
+  GLsizeiptr size = sizeof(GPUTransform) * regionCapacity * TRANSFORM_RING_FRAMES;
+  if(glContext.hasBufferStorage)
+  {
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, size, nullptr, flags);
+    glContext.transformRing = (char*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, size, flags);
+    SM_ASSERT(glContext.transformRing, "Failed to map the Transform Ring");
+  }
+  else
+  {
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    glContext.transformRing = nullptr;
+  }
+
+  glContext.transformRegionCapacity = regionCapacity;
+  glContext.transformRegion = 0;
+}
+
+// Waits until the GPU is done with the Region of this Frame, expects the Ring to be bound,
+// without glBufferStorage the Region has to be unmapped again before drawing
+GPUTransform* gl_map_transform_region()
+{
+  GLsync fence = glContext.transformFences[glContext.transformRegion];
+  if(fence)
+  {
+    while(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
     {
-      glGetProgramInfoLog(glContext.programID, 512, 0, programInfoLog);
+    }
+    glDeleteSync(fence);
+    glContext.transformFences[glContext.transformRegion] = nullptr;
+  }
 
-      SM_ASSERT(0, "Failed to link program: %s", programInfoLog);
-      return false;
+  GLsizeiptr regionSize = sizeof(GPUTransform) * glContext.transformRegionCapacity;
+  GLintptr regionOffset = regionSize * glContext.transformRegion;
+  if(glContext.transformRing)
+  {
+    return (GPUTransform*)(glContext.transformRing + regionOffset);
+  }
+
+  return (GPUTransform*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, regionOffset, regionSize,
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | 
+                                         GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+// Gathers the sorted Transforms straight into the Region, packed if PACKED_TRANSFORMS is set
+void gl_write_render_queue(RenderQueue queue, GPUTransform* region)
+{
+  for(int commandIdx = 0; commandIdx < queue.count; commandIdx++)
+  {
+    Transform transform = queue.transforms[queue.commands[commandIdx].transformIdx];
+#ifdef PACKED_TRANSFORMS
+    region[commandIdx] = pack_transform(transform);
+#else
+    region[commandIdx] = transform;
+#endif
+  }
+}
+
+// Draws count Transforms of the Transform Ring, starting at firstTransformIdx
+void gl_draw_transforms(int firstTransformIdx, int count, bool translucent)
+{
+  if(!count)
+  {
+    return;
+  }
+
+  // Translucent Sprites are drawn back to front, they are depth tested against 
+  // the opaque ones, but don't write depth themselves
+  if(translucent)
+  {
+    glEnable(GL_BLEND);
+    glDepthMask(GL_FALSE);
+  }
+
+  glUniform1i(glContext.transformOffsetID, firstTransformIdx);
+  gl_draw_instances(count);
+
+  if(translucent)
+  {
+    glDisable(GL_BLEND);
+    glDepthMask(GL_TRUE);
+  }
+}
+
+// Runs for the whole Program, so decoding the changed Atlas doesn't stall a frame
+void texture_reload_thread()
+{
+  while(true)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEXTURE_RELOAD_POLL_MS));
+
+    // The last one isn't uploaded yet
+    if(textureReload.ready.load(std::memory_order_acquire))
+    {
+      continue;
+    }
+
+    long long currentTimestamp = get_timestamp(TEXTURE_PATH);
+    if(currentTimestamp > textureReload.timestamp)
+    {
+      int width, height, nChannels;
+      unsigned char* pixels = stbi_load(TEXTURE_PATH, &width, &height, &nChannels, 4);
+      if(pixels)
+      {
+        textureReload.timestamp = currentTimestamp;
+        textureReload.width = width;
+        textureReload.height = height;
+        textureReload.pixels = pixels;
+        textureReload.ready.store(true, std::memory_order_release);
+      }
     }
   }
+}
 
-  glDetachShader(glContext.programID, vertShaderID);
-  glDetachShader(glContext.programID, fragShaderID);
-  glDeleteShader(vertShaderID);
-  glDeleteShader(fragShaderID);
+// Copies the decoded Atlas into the Pixel Buffer, the Texture is filled from
+// that by the Driver, without blocking until the Copy is done
+void gl_upload_texture_reload()
+{
+  if(!textureReload.ready.load(std::memory_order_acquire))
+  {
+    return;
+  }
+
+  int width = textureReload.width;
+  int height = textureReload.height;
+  int size = width * height * 4;
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, glContext.texturePBOID);
+  // Orphans the last Storage, in case the Driver still reads from it
+  glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+  void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, 
+                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  if(dst)
+  {
+    memcpy(dst, textureReload.pixels, size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    // With a Pixel Buffer bound, the data Parameter is an Offset into it
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, glContext.textureID);
+    if(glContext.textureSize.x == width && glContext.textureSize.y == height)
+    {
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, 
+                      GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    else
+    {
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, width, height, 
+                   0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+      glContext.textureSize = {width, height};
+    }
+  }
+
+  // Otherwise the Font Atlas upload would read from the Pixel Buffer as well
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  stbi_image_free(textureReload.pixels);
+  textureReload.pixels = nullptr;
+  textureReload.ready.store(false, std::memory_order_release);
+}
+
+bool gl_init(BumpAllocator* transientStorage)
+{
+  load_gl_functions();
+
+  // Loading a missing Function asserts on Windows and returns a Stub on Linux,
+  // so glBufferStorage is only loaded if the Driver has it
+  glContext.hasBufferStorage = gl_supports_buffer_storage();
+  if(glContext.hasBufferStorage)
+  {
+    glBufferStorage_ptr = 
+      (PFNGLBUFFERSTORAGEPROC) platform_load_gl_function("glBufferStorage");
+  }
+
+  glDebugMessageCallback(&gl_debug_callback, nullptr);
+  glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  glEnable(GL_DEBUG_OUTPUT);
+
+  // Also fetches the Uniform Locations and uses the Program
+  if(!gl_create_programs(transientStorage))
+  {
+    return false;
+  }
 
   // This has to be done, otherwise OpenGL will not draw anything
   GLuint VAO;
@@ -260,22 +877,42 @@ bool gl_init(BumpAllocator* transientStorage)
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, width, height, 
                  0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glContext.textureTimestamp = get_timestamp(TEXTURE_PATH);
+    glContext.textureSize = {width, height};
 
     stbi_image_free(data);
+
+    // Reloads are decoded on the Thread and uploaded through the Pixel Buffer
+    glGenBuffers(1, &glContext.texturePBOID);
+    textureReload.timestamp = get_timestamp(TEXTURE_PATH);
+    std::thread(texture_reload_thread).detach();
   }
 
   // Load Font
   {
-    load_font("assets/fonts/AtariClassic-gry3.ttf", 8);
+    load_font((char*)FONT_PATH, FONT_SIZE, (char*)BAKED_FONT_PATH);
   }
 
-  // Transform Storage Buffer
+  // Render Target, sized in gl_render(), the Game can change its Resolution
   {
-    glGenBuffers(1, &glContext.transformSBOID);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glContext.transformSBOID);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Transform) * renderData->transforms.maxElements,
-                 renderData->transforms.elements, GL_DYNAMIC_DRAW);
+    glGenFramebuffers(1, &glContext.renderTargetFBOID);
+    glGenRenderbuffers(1, &glContext.renderTargetColorID);
+    glGenRenderbuffers(1, &glContext.renderTargetDepthID);
+  }
+
+  // Transform Ring, grows in gl_render() if a Frame needs more
+  {
+    gl_create_transform_ring(TRANSFORM_CHUNK_SIZE);
+  }
+
+  // Tile Map Texture, uploaded once the Game has written the Tile Map, see gl_upload_tile_map()
+  {
+    glGenTextures(1, &glContext.tileMapTextureID);
+    glActiveTexture(GL_TEXTURE2); // Bound to binding = 2, see tilemap.frag
+    glBindTexture(GL_TEXTURE_2D, glContext.tileMapTextureID);
+
+    // Integer Textures can't be filtered
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
   }
 
   // Materials Storage Buffer
@@ -286,12 +923,6 @@ bool gl_init(BumpAllocator* transientStorage)
                  renderData->materials.elements, GL_DYNAMIC_DRAW);
   }
 
-  // Uniforms
-  {
-    glContext.screenSizeID = glGetUniformLocation(glContext.programID, "screenSize");
-    glContext.orthoProjectionID = glGetUniformLocation(glContext.programID, "orthoProjection");
-  }
-  
   // sRGB output (even if input texture is non-sRGB -> don't rely on texture used)
   // Your font is not using sRGB, for example (not that it matters there, because no actual color is sampled from it)
   // But this could prevent some future bug when you start mixing different types of textures
@@ -303,86 +934,54 @@ bool gl_init(BumpAllocator* transientStorage)
   glEnable(GL_DEPTH_TEST);
   glDepthFunc(GL_GREATER);
 
-  // Use Program
-  glUseProgram(glContext.programID);
+  // Blending, only enabled for translucent Sprites
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
   return true;
 }
 
+// Reset for next Frame, also when nothing was drawn, the Transform Lists point
+// into the transient Storage, which the Platform resets after every Frame
+void gl_end_frame()
+{
+  clear_transforms(&renderData->transforms);
+  clear_transforms(&renderData->uiTransforms);
+  reset_materials_if_full();
+  reset_text_layouts_if_full();
+
+  // Shelves used this frame can be evicted from now on
+  renderData->fontCache.frame++;
+}
+
 void gl_render(BumpAllocator* transientStorage)
 {
-  // Texture Hot Reloading
-  {
-    long long currentTimestamp = get_timestamp(TEXTURE_PATH);
+  // Texture Hot Reloading, decoded by texture_reload_thread()
+  gl_upload_texture_reload();
 
-    if(currentTimestamp > glContext.textureTimestamp)
-    {    
-      glActiveTexture(GL_TEXTURE0);
-      int width, height, nChannels;
-      char* data = (char*)stbi_load(TEXTURE_PATH, &width, &height, &nChannels, 4);
-      if(data)
-      {
-        glContext.textureTimestamp = currentTimestamp;
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        stbi_image_free(data);
-      }
-    }
+  // Shader Hot Reloading, the last Frame stays on Screen until the Shaders compile again
+  if(gl_get_shader_timestamp() > glContext.shaderTimestamp && 
+     !gl_create_programs(transientStorage))
+  {
+    gl_present_render_target();
+    gl_end_frame();
+    return;
   }
 
-  // Shader Hot Reloading
+  // Drawn at the Resolution of the Render Target, scaled up to the Screen at the end
+  IVec2 renderTargetSize = get_render_target_size();
+  if(renderTargetSize != glContext.renderTargetSize)
   {
-    long long timestampVert = get_timestamp("assets/shaders/quad.vert");
-    long long timestampFrag = get_timestamp("assets/shaders/quad.frag");
-    
-    if(timestampVert > glContext.shaderTimestamp ||
-       timestampFrag > glContext.shaderTimestamp)
-    {
-      GLuint vertShaderID = gl_create_shader(GL_VERTEX_SHADER, 
-                                              "assets/shaders/quad.vert", transientStorage);
-      GLuint fragShaderID = gl_create_shader(GL_FRAGMENT_SHADER, 
-                                              "assets/shaders/quad.frag", transientStorage);
-      if(!vertShaderID || !fragShaderID)
-      {
-        SM_ASSERT(false, "Failed to create Shaders")
-        return;
-      }
-      GLuint programID = glCreateProgram();
-      glAttachShader(programID, vertShaderID);
-      glAttachShader(programID, fragShaderID);
-      glLinkProgram(programID);
-
-      glDetachShader(programID, vertShaderID);
-      glDetachShader(programID, fragShaderID);
-      glDeleteShader(vertShaderID);
-      glDeleteShader(fragShaderID);
-
-      // Validate if program works
-      {
-        int programSuccess;
-        char programInfoLog[512];
-        glGetProgramiv(programID, GL_LINK_STATUS, &programSuccess);
-
-        if(!programSuccess)
-        {
-          glGetProgramInfoLog(programID, 512, 0, programInfoLog);
-
-          SM_ASSERT(0, "Failed to link program: %s", programInfoLog);
-          return;
-        }
-      }
-
-      glDeleteProgram(glContext.programID);
-      glContext.programID = programID;
-      glUseProgram(programID);
-
-      glContext.shaderTimestamp = max(timestampVert, timestampFrag);
-    }
+    gl_resize_render_target(renderTargetSize);
   }
+  glBindFramebuffer(GL_FRAMEBUFFER, glContext.renderTargetFBOID);
 
   glClearColor(119.0f / 255.0f, 33.0f / 255.0f, 111.0f / 255.0f, 1.0f);
   glClearDepth(0.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glViewport(0, 0, input->screenSize.x, input->screenSize.y);
+  glViewport(0, 0, renderTargetSize.x, renderTargetSize.y);
+
+  renderData->instanceCount = 0;
+  renderData->drawCallCount = 0;
 
   // Copy screen size to the GPU
   {
@@ -390,38 +989,96 @@ void gl_render(BumpAllocator* transientStorage)
     glUniform2fv(glContext.screenSizeID, 1, &screenSize.x);
   }
 
-  // Copy Materials to the GPU
+  gl_upload_font_atlas();
+
+  // Copy new Materials to the GPU, the ones already uploaded stay valid
   {
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, glContext.materialSBOID);
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, 
-                    sizeof(Material) * renderData->materials.count,
-                    renderData->materials.elements);
-    renderData->materials.clear();
-  }
 
-  // Bind back the Transform Buffer
-  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glContext.transformSBOID);
+    int newMaterialCount = renderData->materials.count - renderData->uploadedMaterialCount;
+    if(newMaterialCount > 0)
+    {
+      glBufferSubData(GL_SHADER_STORAGE_BUFFER, 
+                      sizeof(Material) * renderData->uploadedMaterialCount, 
+                      sizeof(Material) * newMaterialCount,
+                      &renderData->materials.elements[renderData->uploadedMaterialCount]);
+      renderData->uploadedMaterialCount = renderData->materials.count;
+    }
+  }
 
-  // Game Pass
+  // Both Queues are written into this Frame's Region of the Transform Ring, 
+  // the Game Pass at its start and the UI Pass right after it
+  RenderQueue gameQueue = build_render_queue(&renderData->transforms, transientStorage);
+  RenderQueue uiQueue = build_render_queue(&renderData->uiTransforms, transientStorage);
+  int gameTransformIdx = 0;
+  int uiTransformIdx = 0;
   {
-    // Game Orthographic Projection
+    int transformCount = gameQueue.count + uiQueue.count;
+    if(transformCount > glContext.transformRegionCapacity)
     {
-      OrthographicCamera2D camera = renderData->gameCamera;
-      Mat4 orthoProjection = orthographic_projection(camera.position.x - camera.dimensions.x / 2.0f, 
-                                                    camera.position.x + camera.dimensions.x / 2.0f, 
-                                                    camera.position.y - camera.dimensions.y / 2.0f, 
-                                                    camera.position.y + camera.dimensions.y / 2.0f);
-      glUniformMatrix4fv(glContext.orthoProjectionID, 1, GL_FALSE, &orthoProjection.ax);
+      int chunkCount = (transformCount + TRANSFORM_CHUNK_SIZE - 1) / TRANSFORM_CHUNK_SIZE;
+      gl_create_transform_ring(chunkCount * TRANSFORM_CHUNK_SIZE);
     }
 
-    // Copy transforms to the GPU
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Transform) * renderData->transforms.count,
-                    renderData->transforms.elements);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glContext.transformSBOID);
+    GPUTransform* region = gl_map_transform_region();
+    if(!region)
+    {
+      SM_ASSERT(false, "Failed to map the Transform Ring");
+      return;
+    }
 
-    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, renderData->transforms.count);
+    gl_write_render_queue(gameQueue, region);
+    gl_write_render_queue(uiQueue, &region[gameQueue.count]);
+    if(!glContext.transformRing)
+    {
+      glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    }
 
-    // Reset for next Frame
-    renderData->transforms.count = 0;
+    gameTransformIdx = glContext.transformRegion * glContext.transformRegionCapacity;
+    uiTransformIdx = gameTransformIdx + gameQueue.count;
+  }
+
+  // Game Pass
+  {
+    // Game Orthographic Projection, the Tile Map uses it too
+    OrthographicCamera2D camera = renderData->gameCamera;
+    Mat4 orthoProjection = orthographic_projection(camera.position.x - camera.dimensions.x / 2.0f, 
+                                                  camera.position.x + camera.dimensions.x / 2.0f, 
+                                                  camera.position.y - camera.dimensions.y / 2.0f, 
+                                                  camera.position.y + camera.dimensions.y / 2.0f);
+    glUniformMatrix4fv(glContext.orthoProjectionID, 1, GL_FALSE, &orthoProjection.ax);
+
+    gl_draw_transforms(gameTransformIdx, gameQueue.opaqueCount, false);
+
+    // Tile Layer, drawn after the other opaque Transforms like before, one Draw
+    // over the visible Tiles, no matter how big the Tile Map is
+    {
+      gl_upload_tile_map();
+
+      IRect visibleTiles = get_visible_tiles(renderData->gameCamera);
+      if(visibleTiles.size.x && visibleTiles.size.y)
+      {
+        float tileSize = (float)renderData->tileSize;
+        Vec2 tileMapPos = {visibleTiles.pos.x * tileSize, visibleTiles.pos.y * tileSize};
+        Vec2 tileMapSize = {visibleTiles.size.x * tileSize, visibleTiles.size.y * tileSize};
+
+        glUseProgram(glContext.tileMapProgramID);
+        glUniformMatrix4fv(glContext.tileOrthoProjectionID, 1, GL_FALSE, &orthoProjection.ax);
+        glUniform2fv(glContext.tileMapPosID, 1, &tileMapPos.x);
+        glUniform2fv(glContext.tileMapSizeID, 1, &tileMapSize.x);
+        glUniform1f(glContext.tileLayerID, renderData->tileLayer);
+        glUniform1i(glContext.tileSizeID, renderData->tileSize);
+        glUniform1i(glContext.tileMaterialIdxID, renderData->tileMaterialIdx);
+        glUniform2iv(glContext.tileAtlasOffsetsID, renderData->tileTypeCount, 
+                     &renderData->tileAtlasOffsets[0].x);
+        gl_draw_instances(1);
+        glUseProgram(glContext.programID);
+      }
+    }
+
+    gl_draw_transforms(gameTransformIdx + gameQueue.opaqueCount, 
+                       gameQueue.count - gameQueue.opaqueCount, true);
   }
 
   // UI Pass
@@ -436,15 +1093,18 @@ void gl_render(BumpAllocator* transientStorage)
       glUniformMatrix4fv(glContext.orthoProjectionID, 1, GL_FALSE, &orthoProjection.ax);
     }
 
-    // Copy transforms to the GPU
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Transform) * renderData->uiTransforms.count,
-                    renderData->uiTransforms.elements);
+    gl_draw_transforms(uiTransformIdx, uiQueue.opaqueCount, false);
+    gl_draw_transforms(uiTransformIdx + uiQueue.opaqueCount, 
+                       uiQueue.count - uiQueue.opaqueCount, true);
+  }
 
-    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, renderData->uiTransforms.count);
+  // The Region is free again once the GPU is past this Frame's Draws
+  glContext.transformFences[glContext.transformRegion] = 
+    glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glContext.transformRegion = (glContext.transformRegion + 1) % TRANSFORM_RING_FRAMES;
 
-    // Reset for next Frame
-    renderData->uiTransforms.count = 0;
-  }
+  gl_present_render_target();
+  gl_end_frame();
 }
 
 
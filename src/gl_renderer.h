@@ -17,6 +17,7 @@ static PFNGLUNIFORM1FPROC glUniform1f_ptr;
 static PFNGLUNIFORM2FVPROC glUniform2fv_ptr;
 static PFNGLUNIFORM3FVPROC glUniform3fv_ptr;
 static PFNGLUNIFORM1IPROC glUniform1i_ptr;
+static PFNGLUNIFORM2IVPROC glUniform2iv_ptr;
 static PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv_ptr;
 static PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor_ptr;
 static PFNGLACTIVETEXTUREPROC glActiveTexture_ptr;
@@ -28,6 +29,11 @@ static PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers_ptr;
 static PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D_ptr;
 static PFNGLDRAWBUFFERSPROC glDrawBuffers_ptr;
 static PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers_ptr;
+static PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer_ptr;
+static PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers_ptr;
+static PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer_ptr;
+static PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage_ptr;
+static PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer_ptr;
 static PFNGLBLENDFUNCIPROC glBlendFunci_ptr;
 static PFNGLBLENDEQUATIONPROC glBlendEquation_ptr;
 static PFNGLCLEARBUFFERFVPROC glClearBufferfv_ptr;
@@ -49,6 +55,17 @@ static PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer_ptr;
 static PFNGLBINDBUFFERPROC glBindBuffer_ptr;
 static PFNGLBINDBUFFERBASEPROC glBindBufferBase_ptr;
 static PFNGLBUFFERDATAPROC glBufferData_ptr;
+static PFNGLMAPBUFFERRANGEPROC glMapBufferRange_ptr;
+static PFNGLUNMAPBUFFERPROC glUnmapBuffer_ptr;
+// Only loaded if the Driver supports it, see gl_supports_buffer_storage()
+static PFNGLBUFFERSTORAGEPROC glBufferStorage_ptr;
+static PFNGLGETSTRINGIPROC glGetStringi_ptr;
+static PFNGLFENCESYNCPROC glFenceSync_ptr;
+static PFNGLCLIENTWAITSYNCPROC glClientWaitSync_ptr;
+static PFNGLDELETESYNCPROC glDeleteSync_ptr;
+static PFNGLPROGRAMPARAMETERIPROC glProgramParameteri_ptr;
+static PFNGLGETPROGRAMBINARYPROC glGetProgramBinary_ptr;
+static PFNGLPROGRAMBINARYPROC glProgramBinary_ptr;
 static PFNGLGETVERTEXATTRIBPOINTERVPROC glGetVertexAttribPointerv_ptr;
 static PFNGLUSEPROGRAMPROC glUseProgram_ptr;
 static PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays_ptr;
@@ -75,6 +92,7 @@ void load_gl_functions()
   glUniform2fv_ptr = (PFNGLUNIFORM2FVPROC) platform_load_gl_function("glUniform2fv");
   glUniform3fv_ptr = (PFNGLUNIFORM3FVPROC) platform_load_gl_function("glUniform3fv");
   glUniform1i_ptr = (PFNGLUNIFORM1IPROC) platform_load_gl_function("glUniform1i");
+  glUniform2iv_ptr = (PFNGLUNIFORM2IVPROC) platform_load_gl_function("glUniform2iv");
   glUniformMatrix4fv_ptr = (PFNGLUNIFORMMATRIX4FVPROC) platform_load_gl_function("glUniformMatrix4fv");
   glVertexAttribDivisor_ptr = (PFNGLVERTEXATTRIBDIVISORPROC) platform_load_gl_function("glVertexAttribDivisor");
   glActiveTexture_ptr = (PFNGLACTIVETEXTUREPROC) platform_load_gl_function("glActiveTexture");
@@ -86,6 +104,11 @@ void load_gl_functions()
   glFramebufferTexture2D_ptr = (PFNGLFRAMEBUFFERTEXTURE2DPROC) platform_load_gl_function("glFramebufferTexture2D");
   glDrawBuffers_ptr = (PFNGLDRAWBUFFERSPROC) platform_load_gl_function("glDrawBuffers");
   glDeleteFramebuffers_ptr = (PFNGLDELETEFRAMEBUFFERSPROC) platform_load_gl_function("glDeleteFramebuffers");
+  glBlitFramebuffer_ptr = (PFNGLBLITFRAMEBUFFERPROC) platform_load_gl_function("glBlitFramebuffer");
+  glGenRenderbuffers_ptr = (PFNGLGENRENDERBUFFERSPROC) platform_load_gl_function("glGenRenderbuffers");
+  glBindRenderbuffer_ptr = (PFNGLBINDRENDERBUFFERPROC) platform_load_gl_function("glBindRenderbuffer");
+  glRenderbufferStorage_ptr = (PFNGLRENDERBUFFERSTORAGEPROC) platform_load_gl_function("glRenderbufferStorage");
+  glFramebufferRenderbuffer_ptr = (PFNGLFRAMEBUFFERRENDERBUFFERPROC) platform_load_gl_function("glFramebufferRenderbuffer");
   glBlendFunci_ptr = (PFNGLBLENDFUNCIPROC) platform_load_gl_function("glBlendFunci");
   glBlendEquation_ptr = (PFNGLBLENDEQUATIONPROC) platform_load_gl_function("glBlendEquation");
   glClearBufferfv_ptr = (PFNGLCLEARBUFFERFVPROC) platform_load_gl_function("glClearBufferfv");
@@ -107,6 +130,15 @@ void load_gl_functions()
   glBindBuffer_ptr = (PFNGLBINDBUFFERPROC) platform_load_gl_function("glBindBuffer");
   glBindBufferBase_ptr = (PFNGLBINDBUFFERBASEPROC) platform_load_gl_function("glBindBufferBase");
   glBufferData_ptr = (PFNGLBUFFERDATAPROC) platform_load_gl_function("glBufferData");
+  glMapBufferRange_ptr = (PFNGLMAPBUFFERRANGEPROC) platform_load_gl_function("glMapBufferRange");
+  glUnmapBuffer_ptr = (PFNGLUNMAPBUFFERPROC) platform_load_gl_function("glUnmapBuffer");
+  glGetStringi_ptr = (PFNGLGETSTRINGIPROC) platform_load_gl_function("glGetStringi");
+  glFenceSync_ptr = (PFNGLFENCESYNCPROC) platform_load_gl_function("glFenceSync");
+  glClientWaitSync_ptr = (PFNGLCLIENTWAITSYNCPROC) platform_load_gl_function("glClientWaitSync");
+  glDeleteSync_ptr = (PFNGLDELETESYNCPROC) platform_load_gl_function("glDeleteSync");
+  glProgramParameteri_ptr = (PFNGLPROGRAMPARAMETERIPROC) platform_load_gl_function("glProgramParameteri");
+  glGetProgramBinary_ptr = (PFNGLGETPROGRAMBINARYPROC) platform_load_gl_function("glGetProgramBinary");
+  glProgramBinary_ptr = (PFNGLPROGRAMBINARYPROC) platform_load_gl_function("glProgramBinary");
   glGetVertexAttribPointerv_ptr = (PFNGLGETVERTEXATTRIBPOINTERVPROC) platform_load_gl_function("glGetVertexAttribPointerv");
   glUseProgram_ptr = (PFNGLUSEPROGRAMPROC) platform_load_gl_function("glUseProgram");
   glDeleteVertexArrays_ptr = (PFNGLDELETEVERTEXARRAYSPROC) platform_load_gl_function("glDeleteVertexArrays");
@@ -177,6 +209,11 @@ void glUniform1i(GLint location, GLint v0)
     glUniform1i_ptr(location, v0);
 }
 
+void glUniform2iv(GLint location, GLsizei count, const GLint* value)
+{
+    glUniform2iv_ptr(location, count, value);
+}
+
 void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
     glUniformMatrix4fv_ptr(location, count, transpose, value);
@@ -232,6 +269,34 @@ void glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
     glDeleteFramebuffers_ptr(n, framebuffers);
 }
 
+void glBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, 
+                       GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, 
+                       GLbitfield mask, GLenum filter)
+{
+    glBlitFramebuffer_ptr(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+void glGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    glGenRenderbuffers_ptr(n, renderbuffers);
+}
+
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    glBindRenderbuffer_ptr(target, renderbuffer);
+}
+
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    glRenderbufferStorage_ptr(target, internalformat, width, height);
+}
+
+void glFramebufferRenderbuffer(GLenum target, GLenum attachment, 
+                               GLenum renderbuffertarget, GLuint renderbuffer)
+{
+    glFramebufferRenderbuffer_ptr(target, attachment, renderbuffertarget, renderbuffer);
+}
+
 void glBlendFunci(GLuint buf, GLenum src, GLenum dst)
 {
     glBlendFunci_ptr(buf, src, dst);
@@ -337,6 +402,58 @@ void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage
     glBufferData_ptr(target, size, data, usage);
 }
 
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    return glMapBufferRange_ptr(target, offset, length, access);
+}
+
+GLboolean glUnmapBuffer(GLenum target)
+{
+    return glUnmapBuffer_ptr(target);
+}
+
+// Core since 4.4, older Drivers may only have it through ARB_buffer_storage
+const GLubyte* glGetStringi(GLenum name, GLuint index)
+{
+    return glGetStringi_ptr(name, index);
+}
+
+void glBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags)
+{
+    glBufferStorage_ptr(target, size, data, flags);
+}
+
+GLsync glFenceSync(GLenum condition, GLbitfield flags)
+{
+    return glFenceSync_ptr(condition, flags);
+}
+
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    return glClientWaitSync_ptr(sync, flags, timeout);
+}
+
+void glDeleteSync(GLsync sync)
+{
+    glDeleteSync_ptr(sync);
+}
+
+void glProgramParameteri(GLuint program, GLenum pname, GLint value)
+{
+    glProgramParameteri_ptr(program, pname, value);
+}
+
+void glGetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, 
+                        GLenum* binaryFormat, void* binary)
+{
+    glGetProgramBinary_ptr(program, bufSize, length, binaryFormat, binary);
+}
+
+void glProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+{
+    glProgramBinary_ptr(program, binaryFormat, binary, length);
+}
+
 void glGetVertexAttribPointerv(GLuint index, GLenum pname, void** pointer)
 {
     glGetVertexAttribPointerv_ptr(index, pname, pointer);
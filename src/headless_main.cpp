@@ -0,0 +1,557 @@
+// #############################################################################
+//                           Headless Simulation Runner
+// #############################################################################
+// Runs update_game without a window, OpenGL or Audio. Every call to
+// update_game is passed UPDATE_DELAY, so one call is one simulate() tick.
+// The game code is compiled in directly, there is no DLL hot reloading here.
+//
+// Usage: schnitzel_headless [options] [tickCount] [scriptPath]
+//
+// --actors count     walls in the Level and spawns count bouncing Actors, used to
+//                    benchmark update_actors()
+// --record path      records the Input of every tick into a Replay
+// --replay path      plays a Replay recorded here or with schnitzel --record, as fast
+//                    as possible and until it ends, tickCount and scriptPath are ignored,
+//                    fails the run if the Replay is empty, truncated or not a Replay
+// --dump-state path  writes the simulated State after the last tick, compare the
+//                    dumps or the printed State hash between engine builds
+// --dump-frame path  renders the last tick with the Software Renderer into a PPM,
+//                    the Frame hash is printed as well
+// --golden-frame path  renders the last tick like --dump-frame and fails the run if
+//                    the Frame hash isn't the one in the File, see run_and_jump.frame
+// --check-packing    renders every tick twice with the Software Renderer, the second
+//                    time with the Transforms packed like PACKED_TRANSFORMS builds draw
+//                    them, fails the run if a Frame hash differs
+// --menu             starts in the Main Menu instead of the Level
+//
+// Script format, one event per line, ordered by tick, '#' starts a comment:
+//   <tick> <keyName> down|up
+//   <tick> mouse <screenX> <screenY>
+#include "game.cpp"
+
+// Renders without a GPU, only used for --dump-frame, --golden-frame and --check-packing
+#include "sw_renderer.cpp"
+
+// Used to measure the Throughput
+#include <chrono>
+
+// #############################################################################
+//                           Headless Constants
+// #############################################################################
+constexpr int HEADLESS_DEFAULT_TICKS = 10000;
+constexpr int HEADLESS_MAX_SCRIPT_EVENTS = 4096;
+constexpr IVec2 HEADLESS_SCREEN_SIZE = {1280, 720};
+
+// #############################################################################
+//                           Headless Structs
+// #############################################################################
+enum ScriptEventType
+{
+  SCRIPT_EVENT_KEY,
+  SCRIPT_EVENT_MOUSE,
+};
+
+struct ScriptEvent
+{
+  ScriptEventType type;
+  int tick;
+  KeyCodeID keyCode;
+  bool isDown;
+  IVec2 mousePos;
+};
+
+struct KeyName
+{
+  char* name;
+  KeyCodeID keyCode;
+};
+
+// #############################################################################
+//                           Headless Globals
+// #############################################################################
+static KeyName keyNames[] =
+{
+  {"mouse_left", KEY_MOUSE_LEFT},
+  {"mouse_right", KEY_MOUSE_RIGHT},
+  {"left", KEY_LEFT},
+  {"right", KEY_RIGHT},
+  {"up", KEY_UP},
+  {"down", KEY_DOWN},
+  {"space", KEY_SPACE},
+  {"escape", KEY_ESCAPE},
+  {"r", KEY_R},
+  {"a", KEY_A},
+  {"d", KEY_D},
+  {"s", KEY_S},
+  {"w", KEY_W},
+};
+
+// #############################################################################
+//                           Headless Functions
+// #############################################################################
+void spawn_benchmark_actors(int actorCount)
+{
+  SM_ASSERT(actorCount <= MAX_ACTORS, "Can't spawn more than %d Actors", MAX_ACTORS);
+
+  // Floor and Walls, so the Actors land and bounce instead of leaving the World
+  for(int x = 0; x < WORLD_GRID.x; x++)
+  {
+    set_tile_visible(x, WORLD_GRID.y - 1, true);
+  }
+  for(int y = 0; y < WORLD_GRID.y; y++)
+  {
+    set_tile_visible(0, y, true);
+    set_tile_visible(WORLD_GRID.x - 1, y, true);
+  }
+  autotile_all_tiles();
+
+  // Spread over the inside of the Level, with different speeds
+  int spawnWidth = WORLD_WIDTH - 4 * TILESIZE;
+  int spawnHeight = WORLD_HEIGHT - 4 * TILESIZE;
+  for(int actorIdx = 0; actorIdx < actorCount; actorIdx++)
+  {
+    IVec2 pos = 
+    {
+      2 * TILESIZE + (actorIdx * 7) % spawnWidth, 
+      2 * TILESIZE + (actorIdx * 13) % spawnHeight
+    };
+    Vec2 speed = {(float)(actorIdx % 9 - 4) * 0.5f, -(float)(actorIdx % 5)};
+    spawn_actor(pos, {8, 8}, speed, ACTOR_FLAG_GRAVITY | ACTOR_FLAG_BOUNCE);
+  }
+}
+
+bool find_key_code(char* name, KeyCodeID* keyCode)
+{
+  for(int keyIdx = 0; keyIdx < ArraySize(keyNames); keyIdx++)
+  {
+    if(strcmp(keyNames[keyIdx].name, name) == 0)
+    {
+      *keyCode = keyNames[keyIdx].keyCode;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool load_script(char* scriptPath,
+                 Array<ScriptEvent, HEADLESS_MAX_SCRIPT_EVENTS>* events,
+                 BumpAllocator* transientStorage)
+{
+  int fileSize = 0;
+  char* script = read_file(scriptPath, &fileSize, transientStorage);
+  if(!script)
+  {
+    SM_ERROR("Failed to load Script: %s", scriptPath);
+    return false;
+  }
+
+  int lineNumber = 0;
+  char* line = strtok(script, "\n");
+  while(line)
+  {
+    lineNumber++;
+
+    char* comment = strchr(line, '#');
+    if(comment)
+    {
+      *comment = 0;
+    }
+
+    ScriptEvent event = {};
+    char name[32] = {};
+    char state[8] = {};
+    int x, y;
+
+    if(sscanf(line, "%d mouse %d %d", &event.tick, &x, &y) == 3)
+    {
+      event.type = SCRIPT_EVENT_MOUSE;
+      event.mousePos = {x, y};
+    }
+    else if(sscanf(line, "%d %31s %7s", &event.tick, name, state) == 3)
+    {
+      event.type = SCRIPT_EVENT_KEY;
+      event.isDown = strcmp(state, "down") == 0;
+
+      if(!find_key_code(name, &event.keyCode) ||
+         (!event.isDown && strcmp(state, "up") != 0))
+      {
+        SM_ERROR("%s:%d: Unknown Key Event: %s %s", scriptPath, lineNumber, name, state);
+        return false;
+      }
+    }
+    else
+    {
+      // Empty or comment Line
+      line = strtok(0, "\n");
+      continue;
+    }
+
+    if(events->count && events->elements[events->count - 1].tick > event.tick)
+    {
+      SM_ERROR("%s:%d: Events have to be ordered by tick", scriptPath, lineNumber);
+      return false;
+    }
+
+    if(events->is_full())
+    {
+      SM_ERROR("%s: More than %d Events", scriptPath, HEADLESS_MAX_SCRIPT_EVENTS);
+      return false;
+    }
+
+    events->add(event);
+    line = strtok(0, "\n");
+  }
+
+  return true;
+}
+
+// Same transitions as platform_update_window() produces
+void apply_script_event(ScriptEvent event)
+{
+  switch(event.type)
+  {
+    case SCRIPT_EVENT_KEY:
+    {
+      Key* key = &input->keys[event.keyCode];
+
+      key->justPressed = !key->justPressed && !key->isDown && event.isDown;
+      key->justReleased = !key->justReleased && key->isDown && !event.isDown;
+      key->isDown = event.isDown;
+      key->halfTransitionCount++;
+      break;
+    }
+
+    case SCRIPT_EVENT_MOUSE:
+    {
+      input->mousePos = event.mousePos;
+      input->mousePosWorld = screen_to_world(input->mousePos);
+      break;
+    }
+  }
+}
+
+// The File holds the Frame hash in hex, Lines starting with '#' are comments
+bool load_golden_frame_hash(char* goldenFramePath, uint64_t* frameHash, 
+                            BumpAllocator* transientStorage)
+{
+  int fileSize = 0;
+  char* file = read_file(goldenFramePath, &fileSize, transientStorage);
+  if(!file)
+  {
+    SM_ERROR("Failed to load Golden Frame: %s", goldenFramePath);
+    return false;
+  }
+
+  char* line = strtok(file, "\n");
+  while(line)
+  {
+    unsigned long long hash = 0;
+    if(line[0] != '#' && sscanf(line, "%llx", &hash) == 1)
+    {
+      *frameHash = hash;
+      return true;
+    }
+    line = strtok(0, "\n");
+  }
+
+  SM_ERROR("%s: No Frame hash", goldenFramePath);
+  return false;
+}
+
+// This is what gl_render() and platform_update_audio() reset every frame, 
+// sw_render() leaves it to this
+void reset_frame(RenderData* renderDataIn, SoundState* soundStateIn, BumpAllocator* transientStorage)
+{
+  clear_transforms(&renderDataIn->transforms);
+  clear_transforms(&renderDataIn->uiTransforms);
+  reset_materials_if_full();
+  reset_text_layouts_if_full();
+  renderDataIn->fontCache.frame++;
+  soundStateIn->playingSounds.clear();
+
+  transientStorage->used = 0;
+}
+
+int main(int argc, char** argv)
+{
+  int tickCount = HEADLESS_DEFAULT_TICKS;
+  char* scriptPath = nullptr;
+  int actorCount = 0;
+  char* recordPath = nullptr;
+  char* replayPath = nullptr;
+  char* dumpStatePath = nullptr;
+  char* dumpFramePath = nullptr;
+  char* goldenFramePath = nullptr;
+  bool checkPacking = false;
+  bool startInMenu = false;
+
+  int positionalArgCount = 0;
+  for(int argIdx = 1; argIdx < argc; argIdx++)
+  {
+    if(strcmp(argv[argIdx], "--actors") == 0 && argIdx + 1 < argc)
+    {
+      actorCount = atoi(argv[++argIdx]);
+    }
+    else if(strcmp(argv[argIdx], "--record") == 0 && argIdx + 1 < argc)
+    {
+      recordPath = argv[++argIdx];
+    }
+    else if(strcmp(argv[argIdx], "--replay") == 0 && argIdx + 1 < argc)
+    {
+      replayPath = argv[++argIdx];
+    }
+    else if(strcmp(argv[argIdx], "--dump-state") == 0 && argIdx + 1 < argc)
+    {
+      dumpStatePath = argv[++argIdx];
+    }
+    else if(strcmp(argv[argIdx], "--dump-frame") == 0 && argIdx + 1 < argc)
+    {
+      dumpFramePath = argv[++argIdx];
+    }
+    else if(strcmp(argv[argIdx], "--golden-frame") == 0 && argIdx + 1 < argc)
+    {
+      goldenFramePath = argv[++argIdx];
+    }
+    else if(strcmp(argv[argIdx], "--check-packing") == 0)
+    {
+      checkPacking = true;
+    }
+    else if(strcmp(argv[argIdx], "--menu") == 0)
+    {
+      startInMenu = true;
+    }
+    else if(positionalArgCount++ == 0)
+    {
+      tickCount = atoi(argv[argIdx]);
+    }
+    else
+    {
+      scriptPath = argv[argIdx];
+    }
+  }
+
+  BumpAllocator transientStorage = make_bump_allocator(MB(50));
+  BumpAllocator persistentStorage = make_bump_allocator(MB(256));
+
+  Input* inputIn = (Input*)bump_alloc(&persistentStorage, sizeof(Input));
+  RenderData* renderDataIn = (RenderData*)bump_alloc(&persistentStorage, sizeof(RenderData));
+  GameState* gameStateIn = (GameState*)bump_alloc(&persistentStorage, sizeof(GameState));
+  UIState* uiStateIn = (UIState*)bump_alloc(&persistentStorage, sizeof(UIState));
+  SoundState* soundStateIn = (SoundState*)bump_alloc(&persistentStorage, sizeof(SoundState));
+  if(!inputIn || !renderDataIn || !gameStateIn || !uiStateIn || !soundStateIn)
+  {
+    SM_ERROR("Failed to allocate Game Memory");
+    return -1;
+  }
+
+  renderDataIn->transientStorage = &transientStorage;
+  soundStateIn->transientStorage = &transientStorage;
+  soundStateIn->allocatedsoundsBuffer = bump_alloc(&persistentStorage, SOUNDS_BUFFER_SIZE);
+  if(!soundStateIn->allocatedsoundsBuffer)
+  {
+    SM_ERROR("Failed to allocated Sounds Buffer");
+    return -1;
+  }
+
+  SnapshotState* snapshotStateIn = (SnapshotState*)bump_alloc(&persistentStorage, sizeof(SnapshotState));
+  if(!snapshotStateIn)
+  {
+    SM_ERROR("Failed to allocate SnapshotState");
+    return -1;
+  }
+  snapshotStateIn->buffer = bump_alloc(&persistentStorage, SNAPSHOT_BUFFER_SIZE);
+  snapshotStateIn->checkpoint = bump_alloc(&persistentStorage, sizeof(GameState));
+  if(!snapshotStateIn->buffer || !snapshotStateIn->checkpoint)
+  {
+    SM_ERROR("Failed to allocate Snapshot Buffers");
+    return -1;
+  }
+
+  ReplayState* replayStateIn = (ReplayState*)bump_alloc(&persistentStorage, sizeof(ReplayState));
+  if(!replayStateIn)
+  {
+    SM_ERROR("Failed to allocate ReplayState");
+    return -1;
+  }
+  if(replayPath)
+  {
+    replayStateIn->buffer = read_file(replayPath, &replayStateIn->size, &persistentStorage);
+    if(!replayStateIn->buffer)
+    {
+      SM_ERROR("Failed to load Replay: %s", replayPath);
+      return -1;
+    }
+
+    // A broken Log would otherwise play zero ticks and report a State Hash like a passing run
+    ReplayHeader* header = (ReplayHeader*)replayStateIn->buffer;
+    if(replayStateIn->size < (int)sizeof(ReplayHeader) ||
+       header->magic != REPLAY_MAGIC || header->version != REPLAY_VERSION)
+    {
+      SM_ERROR("Not a Replay or wrong Version: %s", replayPath);
+      return -1;
+    }
+    replayStateIn->mode = REPLAY_MODE_PLAY;
+  }
+  else if(recordPath)
+  {
+    replayStateIn->buffer = bump_alloc(&persistentStorage, REPLAY_BUFFER_SIZE);
+    if(!replayStateIn->buffer)
+    {
+      SM_ERROR("Failed to allocate Replay Buffer");
+      return -1;
+    }
+    replayStateIn->mode = REPLAY_MODE_RECORD;
+  }
+
+  // screen_to_world() divides by the Screen Size, a Replay brings its own
+  inputIn->screenSize = HEADLESS_SCREEN_SIZE;
+
+  // Skip the Main Menu, we want to simulate the Level,
+  // a Replay starts in the State the recorded session started in
+  if(!replayPath && !startInMenu)
+  {
+    gameStateIn->state = GAME_STATE_IN_LEVEL;
+  }
+
+  Array<ScriptEvent, HEADLESS_MAX_SCRIPT_EVENTS>* events =
+    (Array<ScriptEvent, HEADLESS_MAX_SCRIPT_EVENTS>*)
+      bump_alloc(&persistentStorage, sizeof(Array<ScriptEvent, HEADLESS_MAX_SCRIPT_EVENTS>));
+  if(scriptPath && !replayPath && !load_script(scriptPath, events, &transientStorage))
+  {
+    return -1;
+  }
+  transientStorage.used = 0;
+
+  // Binds the game globals and initializes the GameState without simulating,
+  // screen_to_world() needs them before the first Script Event
+  update_game(gameStateIn, renderDataIn, inputIn, soundStateIn, uiStateIn, 
+              snapshotStateIn, replayStateIn, 0.0f);
+  reset_frame(renderDataIn, soundStateIn, &transientStorage);
+
+  if(actorCount)
+  {
+    spawn_benchmark_actors(actorCount);
+  }
+
+  bool renderFrame = dumpFramePath || goldenFramePath || checkPacking;
+  if(renderFrame && !sw_init(HEADLESS_SCREEN_SIZE, &persistentStorage))
+  {
+    return -1;
+  }
+
+  auto startTime = std::chrono::steady_clock::now();
+
+  int eventIdx = 0;
+  int tick = 0;
+  int packingMismatchCount = 0;
+  for(; replayPath? !replayStateIn->finished : tick < tickCount; tick++)
+  {
+    while(eventIdx < events->count && events->elements[eventIdx].tick <= tick)
+    {
+      apply_script_event(events->elements[eventIdx++]);
+    }
+
+    update_game(gameStateIn, renderDataIn, inputIn, soundStateIn, uiStateIn, 
+                snapshotStateIn, replayStateIn, UPDATE_DELAY);
+
+    bool lastTick = replayPath? replayStateIn->finished : tick == tickCount - 1;
+    if(checkPacking)
+    {
+      sw_render(&transientStorage, true);
+      uint64_t packedFrameHash = sw_get_frame_hash();
+      sw_render(&transientStorage);
+      if(sw_get_frame_hash() != packedFrameHash)
+      {
+        if(!packingMismatchCount)
+        {
+          SM_ERROR("Tick %d renders differently with packed Transforms", tick);
+        }
+        packingMismatchCount++;
+      }
+    }
+    else if(renderFrame && lastTick)
+    {
+      sw_render(&transientStorage);
+    }
+
+    if(dumpFramePath && lastTick)
+    {
+      sw_write_frame(dumpFramePath, &transientStorage);
+    }
+
+    reset_frame(renderDataIn, soundStateIn, &transientStorage);
+  }
+
+  if(replayPath && replayStateIn->corrupt)
+  {
+    SM_ERROR("Replay is corrupt, stopped after %d ticks: %s", replayStateIn->tickCount, replayPath);
+    return -1;
+  }
+  if(replayPath && !replayStateIn->tickCount)
+  {
+    SM_ERROR("Replay contains no ticks: %s", replayPath);
+    return -1;
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  tickCount = replayPath? replayStateIn->tickCount : tick;
+
+  Player& player = gameStateIn->player;
+  SM_TRACE("Simulated %d ticks in %.3f s, %.0f ticks/s", tickCount, seconds, (double)tickCount / seconds);
+  SM_TRACE("Player pos: %d, %d speed: %.3f, %.3f", player.pos.x, player.pos.y, player.speed.x, player.speed.y);
+
+  if(actorCount)
+  {
+    SM_TRACE("Moved %d Actors, %.3f us per tick", gameStateIn->actors.count, seconds * 1000000.0 / tickCount);
+  }
+
+  if(recordPath && replayStateIn->size)
+  {
+    write_file(recordPath, replayStateIn->buffer, replayStateIn->size);
+    SM_TRACE("Recorded %d ticks into %s", replayStateIn->tickCount, recordPath);
+  }
+
+  // Same data as a Snapshot, the part of the GameState that is simulated
+  int stateSize = transfer_snapshot(nullptr, true, true);
+  char* stateData = bump_alloc(&transientStorage, stateSize);
+  transfer_snapshot(stateData, true, true);
+  SM_TRACE("State hash: %016llx", (unsigned long long)hash_bytes(stateData, stateSize));
+
+  if(dumpStatePath)
+  {
+    write_file(dumpStatePath, stateData, stateSize);
+  }
+
+  if(renderFrame)
+  {
+    uint64_t frameHash = sw_get_frame_hash();
+    SM_TRACE("Frame hash: %016llx", (unsigned long long)frameHash);
+
+    uint64_t goldenFrameHash = 0;
+    if(goldenFramePath)
+    {
+      if(!load_golden_frame_hash(goldenFramePath, &goldenFrameHash, &transientStorage))
+      {
+        return -1;
+      }
+      if(frameHash != goldenFrameHash)
+      {
+        SM_ERROR("Frame hash doesn't match %016llx of %s", 
+                 (unsigned long long)goldenFrameHash, goldenFramePath);
+        return -1;
+      }
+    }
+  }
+
+  if(checkPacking)
+  {
+    SM_TRACE("Rendered %d ticks packed, %d of them differ", tickCount, packingMismatchCount);
+    if(packingMismatchCount)
+    {
+      return -1;
+    }
+  }
+
+  return 0;
+}
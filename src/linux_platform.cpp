@@ -6,6 +6,8 @@
 #include <GL/glx.h>
 #include <dlfcn.h>  // for loading the so (DLL) file
 #include <unistd.h> // for sleep
+#include <fcntl.h>
+#include <sys/mman.h> // for mapping files
 
 // #############################################################################
 //                           Linux Defines
@@ -374,4 +376,39 @@ void platform_update_audio(float dt)
 void platform_sleep(unsigned int ms)
 {
   sleep(ms);
+}
+
+char* platform_map_file(const char* filePath, long long* fileSize)
+{
+  *fileSize = 0;
+  int file = open(filePath, O_RDONLY);
+  if(file < 0)
+  {
+    return nullptr;
+  }
+
+  struct stat fileStat = {};
+  char* data = nullptr;
+  if(!fstat(file, &fileStat) && fileStat.st_size > 0)
+  {
+    data = (char*)mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if(data == MAP_FAILED)
+    {
+      data = nullptr;
+    }
+    else
+    {
+      *fileSize = fileStat.st_size;
+    }
+  }
+
+  // The Mapping stays valid after closing the File
+  close(file);
+
+  return data;
+}
+
+void platform_unmap_file(char* data, long long fileSize)
+{
+  munmap(data, fileSize);
 }
\ No newline at end of file
@@ -48,11 +48,18 @@ double get_delta_time();
 void reload_game_dll(BumpAllocator* transientStorage);
 
 
-int main()
+// Usage: schnitzel [--record replayPath]
+int main(int argc, char** argv)
 {
   // Initialize timestamp
   get_delta_time();
 
+  char* recordPath = nullptr;
+  if(argc > 2 && strcmp(argv[1], "--record") == 0)
+  {
+    recordPath = argv[2];
+  }
+
   BumpAllocator transientStorage = make_bump_allocator(MB(50));
   BumpAllocator persistentStorage = make_bump_allocator(MB(256));
 
@@ -69,6 +76,7 @@ int main()
     SM_ERROR("Failed to allocate RenderData");
     return -1;
   }
+  renderData->transientStorage = &transientStorage;
 
   gameState = (GameState*)bump_alloc(&persistentStorage, sizeof(GameState));
   if(!gameState)
@@ -98,6 +106,37 @@ int main()
     return -1;
   }
 
+  snapshotState = (SnapshotState*)bump_alloc(&persistentStorage, sizeof(SnapshotState));
+  if(!snapshotState)
+  {
+    SM_ERROR("Failed to allocate SnapshotState");
+    return -1;
+  }
+  snapshotState->buffer = bump_alloc(&persistentStorage, SNAPSHOT_BUFFER_SIZE);
+  snapshotState->checkpoint = bump_alloc(&persistentStorage, sizeof(GameState));
+  if(!snapshotState->buffer || !snapshotState->checkpoint)
+  {
+    SM_ERROR("Failed to allocate Snapshot Buffers");
+    return -1;
+  }
+
+  replayState = (ReplayState*)bump_alloc(&persistentStorage, sizeof(ReplayState));
+  if(!replayState)
+  {
+    SM_ERROR("Failed to allocate ReplayState");
+    return -1;
+  }
+  if(recordPath)
+  {
+    replayState->buffer = bump_alloc(&persistentStorage, REPLAY_BUFFER_SIZE);
+    if(!replayState->buffer)
+    {
+      SM_ERROR("Failed to allocate Replay Buffer");
+      return -1;
+    }
+    replayState->mode = REPLAY_MODE_RECORD;
+  }
+
   platform_create_window(1280, 720, "Schnitzel Motor");
   platform_fill_keycode_lookup_table();
   platform_set_vsync(true);
@@ -117,7 +156,7 @@ int main()
 
     // Update
     platform_update_window();
-    update_game(gameState, renderData, input, soundState, uiState, dt);
+    update_game(gameState, renderData, input, soundState, uiState, snapshotState, replayState, dt);
     gl_render(&transientStorage);
     platform_update_audio(dt);
 
@@ -126,6 +165,12 @@ int main()
     transientStorage.used = 0;
   }
 
+  if(recordPath && replayState->size)
+  {
+    write_file(recordPath, replayState->buffer, replayState->size);
+    SM_TRACE("Recorded %d ticks into %s", replayState->tickCount, recordPath);
+  }
+
   return 0;
 }
 
@@ -134,9 +179,12 @@ void update_game(GameState* gameStateIn,
                 Input* inputIn,
                 SoundState* soundStateIn,
                 UIState* uiStateIn,
+                SnapshotState* snapshotStateIn,
+                ReplayState* replayStateIn,
                 float dt)
 {
-  update_game_ptr(gameStateIn ,renderDataIn, inputIn, soundStateIn, uiStateIn, dt);
+  update_game_ptr(gameStateIn ,renderDataIn, inputIn, soundStateIn, uiStateIn, 
+                  snapshotStateIn, replayStateIn, dt);
 }
 
 double get_delta_time()
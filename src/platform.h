@@ -21,4 +21,6 @@ bool platform_free_dynamic_library(void* dll);
 void platform_fill_keycode_lookup_table();
 bool platform_init_audio();
 void platform_update_audio(float dt);
-void platform_sleep(unsigned int ms);
\ No newline at end of file
+void platform_sleep(unsigned int ms);
+char* platform_map_file(const char* filePath, long long* fileSize);
+void platform_unmap_file(char* data, long long fileSize);
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "assets.h"
+#include "font.h"
 #include "shader_header.h"
 #include "schnitzel_lib.h"
 
@@ -11,6 +12,32 @@
 int RENDER_OPTION_FLIP_X = BIT(0);
 int RENDER_OPTION_FLIP_Y = BIT(1);
 
+// One Byte per Tile, see RenderData::tileMap
+constexpr int MAX_TILE_MAP_TILES = 4096;
+
+// Transform Lists grow by one Chunk at a time, allocated from the transient Storage
+constexpr int TRANSFORM_CHUNK_SIZE = 1024;
+
+// Laid out Text is cached, keyed on the Text, font size and Material
+constexpr int MAX_TEXT_LAYOUTS = 512;
+constexpr int TEXT_LAYOUT_HASH_SLOTS = 1024;
+constexpr int MAX_TEXT_LAYOUT_GLYPHS = 8192;
+
+// Materials are interned through an open addressing table keyed on the sRGB color
+constexpr int MAX_MATERIALS = 1000;
+constexpr int MATERIAL_HASH_SLOTS = 2048; // Has to be a power of two
+
+// Render Keys, sorted ascending
+// Bit  63:      translucent, drawn after the opaque Sprites with blending
+// Bits 62 - 31: layer (sub-layer included) as sortable float Bits, 
+//               inverted for opaque Sprites so they are drawn front to back
+// Bits 30 - 27: texture atlas
+// Bits 26 - 17: material
+constexpr uint64_t RENDER_KEY_TRANSLUCENT_BIT = 1ull << 63;
+constexpr int RENDER_KEY_LAYER_SHIFT = 31;
+constexpr int RENDER_KEY_ATLAS_SHIFT = 27;
+constexpr int RENDER_KEY_MATERIAL_SHIFT = 17;
+
 // #############################################################################
 //                           Renderer Structs
 // #############################################################################
@@ -44,12 +71,31 @@ struct TextData
   float layer = 0.0f;
 };
 
-struct Glyph
+// Glyphs relative to the Text origin, on layer 0
+struct TextLayout
+{
+  uint64_t key;
+  int firstGlyphIdx;
+  int glyphCount;
+  Rect bounds;
+  uint64_t shelfMask; // Font Atlas Shelves the Glyphs live in
+  int fontGeneration; // -1 if Glyphs were missing, never matches
+};
+
+struct TransformChunk
+{
+  TransformChunk* next;
+  int count;
+  Transform transforms[TRANSFORM_CHUNK_SIZE];
+};
+
+// Only valid for one frame, gl_render() resets the Lists after drawing them,
+// before the transient Storage is cleared
+struct TransformList
 {
-  Vec2 offset;
-  Vec2 advance;
-  IVec2 textureCoords;
-  IVec2 size;
+  int count;
+  TransformChunk* first;
+  TransformChunk* last;
 };
 
 struct RenderData
@@ -57,12 +103,59 @@ struct RenderData
   OrthographicCamera2D gameCamera;
   OrthographicCamera2D uiCamera;
 
-  int fontHeight;
-  Glyph glyphs[127];
+  // The Game and UI are drawn at this Resolution and then scaled up to the Screen,
+  // the Screen Size is used if it isn't set, see get_render_target_viewport()
+  IVec2 renderTargetSize;
+
+  FontCache fontCache;
+
+  // Persistent across frames, reset_materials_if_full() drops them between frames
+  Array<Material, MAX_MATERIALS> materials;
+  Vec4 materialColors[MAX_MATERIALS]; // sRGB color each Material was requested with
+  int materialSlots[MATERIAL_HASH_SLOTS]; // materialIdx + 1, 0 is an empty Slot
+  int uploadedMaterialCount;
+
+  // Persistent across frames, reset_text_layouts_if_full() drops them between frames
+  Array<TextLayout, MAX_TEXT_LAYOUTS> textLayouts;
+  int textLayoutSlots[TEXT_LAYOUT_HASH_SLOTS]; // layoutIdx + 1, 0 is an empty Slot
+  Array<Transform, MAX_TEXT_LAYOUT_GLYPHS> textLayoutGlyphs;
+
+  BumpAllocator* transientStorage;
+  TransformList transforms;
+  TransformList uiTransforms;
+
+  // Written by gl_render(), what the last frame submitted
+  int instanceCount;
+  int drawCallCount;
+
+  // Tile Layer, row major, one Tile Type per Tile, 0 is empty, Type n is drawn 
+  // from tileAtlasOffsets[n - 1]. The Game writes it when the Tiles change, the
+  // Renderer only uploads the Tiles inside tileMapDirtyRect, see tilemap.frag
+  uint8_t tileMap[MAX_TILE_MAP_TILES];
+  IVec2 tileMapSize; // In Tiles
+  IRect tileMapDirtyRect;
+  int tileGeneration;
+  int tileSize; // In world units
+  float tileLayer;
+  int tileMaterialIdx;
+  int tileTypeCount;
+  IVec2 tileAtlasOffsets[MAX_TILE_TYPES];
+};
+
+struct RenderCommand
+{
+  uint64_t key;
+  int transformIdx;
+};
 
-  Array<Material, 1000> materials;
-  Array<Transform, 1000> transforms;
-  Array<Transform, 1000> uiTransforms;
+// Commands of one List sorted by Key, the opaque ones come first. The Renderers
+// gather the Transforms in this order straight into what they draw from
+struct RenderQueue
+{
+  Transform* transforms; // In submission order, indexed by RenderCommand::transformIdx
+  RenderCommand* commands;
+  int opaqueCount;
+  int count;
 };
 
 // #############################################################################
@@ -73,19 +166,56 @@ static RenderData* renderData;
 // #############################################################################
 //                           Renderer Untility
 // #############################################################################
+IVec2 get_render_target_size()
+{
+  IVec2 size = renderData->renderTargetSize;
+  if(size.x <= 0 || size.y <= 0)
+  {
+    size = input->screenSize;
+  }
+
+  // Never empty, a minimized Window has no Size
+  return {max(size.x, 1), max(size.y, 1)};
+}
+
+// Where the Render Target ends up on the Screen, Origin at the top left. It is scaled 
+// up by the biggest integer that fits and letterboxed, Screens smaller than the
+// Render Target scale it down to fit instead
+IRect get_render_target_viewport()
+{
+  IVec2 screenSize = input->screenSize;
+  IVec2 targetSize = get_render_target_size();
+  IVec2 size = {};
+  int scale = min(screenSize.x / targetSize.x, screenSize.y / targetSize.y);
+  if(scale >= 1)
+  {
+    size = {targetSize.x * scale, targetSize.y * scale};
+  }
+  else
+  {
+    float fit = min((float)screenSize.x / (float)targetSize.x, 
+                    (float)screenSize.y / (float)targetSize.y);
+    size = {max((int)(targetSize.x * fit), 1), max((int)(targetSize.y * fit), 1)};
+  }
+
+  return {(screenSize.x - size.x) / 2, (screenSize.y - size.y) / 2, size.x, size.y};
+}
+
+// Only the Screen Pixels inside the Viewport of the Render Target show the World
 IVec2 screen_to_world(IVec2 screenPos)
 {
   OrthographicCamera2D camera = renderData->gameCamera;
+  IRect viewport = get_render_target_viewport();
 
-  int xPos = (float)screenPos.x / 
-             (float)input->screenSize.x * 
+  int xPos = (float)(screenPos.x - viewport.pos.x) / 
+             (float)viewport.size.x * 
              camera.dimensions.x; // [0; dimensions.x]
 
   // Offset using dimensions and position
   xPos += -camera.dimensions.x / 2.0f + camera.position.x;
 
-  int yPos = (float)screenPos.y / 
-             (float)input->screenSize.y * 
+  int yPos = (float)(screenPos.y - viewport.pos.y) / 
+             (float)viewport.size.y * 
              camera.dimensions.y; // [0; dimensions.y]
 
   // Offset using dimensions and position
@@ -94,6 +224,68 @@ IVec2 screen_to_world(IVec2 screenPos)
   return {xPos, yPos};
 }
 
+// The Projection flips Y, so the Camera looks at (position.x, -position.y)
+Rect get_camera_rect(OrthographicCamera2D camera)
+{
+  Rect rect = {};
+  rect.pos.x = camera.position.x - camera.dimensions.x / 2.0f;
+  rect.pos.y = -camera.position.y - camera.dimensions.y / 2.0f;
+  rect.size = camera.dimensions;
+  return rect;
+}
+
+// Tiles of the Tile Map inside the Camera, empty if there are none
+IRect get_visible_tiles(OrthographicCamera2D camera)
+{
+  if(!renderData->tileSize)
+  {
+    return {};
+  }
+
+  Rect cameraRect = get_camera_rect(camera);
+  float tileSize = (float)renderData->tileSize;
+  IVec2 mapSize = renderData->tileMapSize;
+  int minX = max(0, (int)floorf(cameraRect.pos.x / tileSize));
+  int minY = max(0, (int)floorf(cameraRect.pos.y / tileSize));
+  int maxX = min(mapSize.x - 1, (int)floorf((cameraRect.pos.x + cameraRect.size.x) / tileSize));
+  int maxY = min(mapSize.y - 1, (int)floorf((cameraRect.pos.y + cameraRect.size.y) / tileSize));
+  if(minX > maxX || minY > maxY)
+  {
+    return {};
+  }
+
+  return {minX, minY, maxX - minX + 1, maxY - minY + 1};
+}
+
+// Only marks the Tile dirty if its Type changed
+void set_tile_map_tile(int x, int y, int tileType)
+{
+  SM_ASSERT(x >= 0 && x < renderData->tileMapSize.x && 
+            y >= 0 && y < renderData->tileMapSize.y, "Tile out of bounds: %d, %d", x, y);
+  SM_ASSERT(tileType >= 0 && tileType <= renderData->tileTypeCount, 
+            "Invalid Tile Type: %d", tileType);
+
+  uint8_t& tile = renderData->tileMap[y * renderData->tileMapSize.x + x];
+  if(tile == tileType)
+  {
+    return;
+  }
+  tile = tileType;
+
+  IRect& dirtyRect = renderData->tileMapDirtyRect;
+  if(!dirtyRect.size.x || !dirtyRect.size.y)
+  {
+    dirtyRect = {x, y, 1, 1};
+    return;
+  }
+
+  int minX = min(dirtyRect.pos.x, x);
+  int minY = min(dirtyRect.pos.y, y);
+  int maxX = max(dirtyRect.pos.x + dirtyRect.size.x, x + 1);
+  int maxY = max(dirtyRect.pos.y + dirtyRect.size.y, y + 1);
+  dirtyRect = {minX, minY, maxX - minX, maxY - minY};
+}
+
 int animate(float* time, int frameCount, float duration = 1.0f)
 {
   while(*time > duration)
@@ -114,21 +306,73 @@ int animate(float* time, int frameCount, float duration = 1.0f)
 
 int get_material_idx(Material material = {})
 {
+  int slotIdx = hash_bytes((char*)&material.color, sizeof(Vec4)) & (MATERIAL_HASH_SLOTS - 1);
+
+  // Linear probing, the table is never more than half full
+  while(renderData->materialSlots[slotIdx])
+  {
+    int materialIdx = renderData->materialSlots[slotIdx] - 1;
+    if(renderData->materialColors[materialIdx] == material.color)
+    {
+      return materialIdx;
+    }
+
+    slotIdx = (slotIdx + 1) & (MATERIAL_HASH_SLOTS - 1);
+  }
+
+  if(renderData->materials.is_full())
+  {
+    SM_ASSERT(false, "Materials are full!");
+    return 0;
+  }
+
+  int materialIdx = renderData->materials.count;
+  renderData->materialColors[materialIdx] = material.color;
+  renderData->materialSlots[slotIdx] = materialIdx + 1;
+
   // Convert from SRGB to linear color space, to be used in the shader, poggies
+  // Only done once, when the Material is added
   material.color.r = powf(material.color.r, 2.2f);
   material.color.g = powf(material.color.g, 2.2f);
   material.color.b = powf(material.color.b, 2.2f);
   material.color.a = powf(material.color.a, 2.2f);
 
-  for(int materialIdx = 0; materialIdx < renderData->materials.count; materialIdx++)
+  return renderData->materials.add(material);
+}
+
+void clear_text_layouts()
+{
+  renderData->textLayouts.clear();
+  renderData->textLayoutGlyphs.clear();
+  memset(renderData->textLayoutSlots, 0, sizeof(renderData->textLayoutSlots));
+}
+
+// Called between frames, so no Transform of the current frame points at a
+// dropped Material. Cached Transforms have to compare their materialIdx.
+void reset_materials_if_full()
+{
+  if(renderData->materials.count < MAX_MATERIALS * 3 / 4)
   {
-    if(renderData->materials[materialIdx] == material)
-    {
-      return materialIdx;
-    }
+    return;
   }
 
-  return renderData->materials.add(material);
+  renderData->materials.clear();
+  memset(renderData->materialSlots, 0, sizeof(renderData->materialSlots));
+  renderData->uploadedMaterialCount = 0;
+
+  // Text Layouts store the materialIdx of their Glyphs
+  clear_text_layouts();
+}
+
+void reset_text_layouts_if_full()
+{
+  if(renderData->textLayouts.count < MAX_TEXT_LAYOUTS * 3 / 4 &&
+     renderData->textLayoutGlyphs.count < MAX_TEXT_LAYOUT_GLYPHS * 3 / 4)
+  {
+    return;
+  }
+
+  clear_text_layouts();
 }
 
 float get_layer(Layer layer, float subLayer = 0.0f)
@@ -146,7 +390,9 @@ Transform get_transform(SpriteID spriteID, Vec2 pos, Vec2 size = {}, DrawData dr
 
   Transform transform = {};
   transform.materialIdx = get_material_idx(drawData.material);
-  transform.pos = pos - size / 2.0f;
+  // On whole Pixels of the Render Target, centered odd sized Sprites would
+  // otherwise sit between two and sample their Texels on the edges
+  transform.pos = {floorf(pos.x - size.x / 2.0f), floorf(pos.y - size.y / 2.0f)};
   transform.size = size;
   transform.atlasOffset = sprite.atlasOffset;
   // For Anmations, this is a multiple of the sprites size,
@@ -159,24 +405,80 @@ Transform get_transform(SpriteID spriteID, Vec2 pos, Vec2 size = {}, DrawData dr
   return transform;
 }
 
+void add_transform(TransformList* list, Transform transform)
+{
+  if(!list->last || list->last->count == TRANSFORM_CHUNK_SIZE)
+  {
+    TransformChunk* chunk = 
+      (TransformChunk*)bump_alloc(renderData->transientStorage, sizeof(TransformChunk));
+    if(!chunk)
+    {
+      SM_ASSERT(false, "No Transient Storage left for Transforms, %d in the List", list->count);
+      return;
+    }
+    chunk->next = nullptr;
+    chunk->count = 0;
+
+    if(list->last)
+    {
+      list->last->next = chunk;
+    }
+    else
+    {
+      list->first = chunk;
+    }
+    list->last = chunk;
+  }
+
+  list->last->transforms[list->last->count++] = transform;
+  list->count++;
+}
+
+void clear_transforms(TransformList* list)
+{
+  *list = {};
+}
+
+// Transforms outside of the Camera never reach the Lists
+bool is_visible(OrthographicCamera2D camera, Transform transform)
+{
+  return rect_collision(get_camera_rect(camera), {transform.pos, transform.size});
+}
+
+void push_game_transform(Transform transform)
+{
+  if(is_visible(renderData->gameCamera, transform))
+  {
+    add_transform(&renderData->transforms, transform);
+  }
+}
+
+void push_ui_transform(Transform transform)
+{
+  if(is_visible(renderData->uiCamera, transform))
+  {
+    add_transform(&renderData->uiTransforms, transform);
+  }
+}
+
 // #############################################################################
 //                           Renderer Functions
 // #############################################################################
 void draw_quad(Transform transform)
 {
-  renderData->transforms.add(transform);
+  push_game_transform(transform);
 }
 
 void draw_quad(Vec2 pos, Vec2 size, DrawData drawData = {})
 {
   Transform transform = get_transform(SPRITE_WHITE, pos, size, drawData);
-  renderData->transforms.add(transform);
+  push_game_transform(transform);
 }
 
 void draw_sprite(SpriteID spriteID, Vec2 pos, DrawData drawData = {})
 {
   Transform transform = get_transform(spriteID, pos, {}, drawData);
-  renderData->transforms.add(transform);
+  push_game_transform(transform);
 }
 
 void draw_sprite(SpriteID spriteID, IVec2 pos, DrawData drawData = {})
@@ -190,13 +492,13 @@ void draw_sprite(SpriteID spriteID, IVec2 pos, DrawData drawData = {})
 void draw_ui_sprite(SpriteID spriteID, Vec2 pos, Vec2 size = {}, DrawData drawData = {})
 {
   Transform transform = get_transform(spriteID, pos, size, drawData);
-  renderData->uiTransforms.add(transform);
+  push_ui_transform(transform);
 }
 
 void draw_ui_sprite(SpriteID spriteID, Vec2 pos, DrawData drawData = {})
 {
   Transform transform = get_transform(spriteID, pos, {}, drawData);
-  renderData->uiTransforms.add(transform);
+  push_ui_transform(transform);
 }
 
 void draw_ui_sprite(SpriteID spriteID, IVec2 pos, DrawData drawData = {})
@@ -207,40 +509,174 @@ void draw_ui_sprite(SpriteID spriteID, IVec2 pos, DrawData drawData = {})
 // #############################################################################
 //                     Render Interface UI Font Rendering
 // #############################################################################
-void draw_ui_text(char* text, Vec2 pos, TextData textData = {})
+uint64_t get_text_layout_key(char* text, TextData textData)
 {
-  SM_ASSERT(text, "No Text Supplied!");
-  if(!text)
-  {
-    return;
-  }
+  uint64_t key = hash_bytes(text, strlen(text));
+  key = hash_bytes((char*)&textData.fontSize, sizeof(float), key);
+  key = hash_bytes((char*)&textData.material.color, sizeof(Vec4), key);
+  key = hash_bytes((char*)&textData.renderOptions, sizeof(int), key);
+  return key;
+}
 
-  Vec2 origin = pos;
-  while(char c = *(text++))
+// Writes the Glyphs of the UTF-8 Text relative to its origin into glyphs, 
+// which needs space for strlen(text) Transforms
+int layout_text(char* text, TextData textData, Transform* glyphs, Rect* bounds, 
+                uint64_t* shelfMask)
+{
+  int materialIdx = get_material_idx(textData.material);
+  int glyphCount = 0;
+  Vec2 minPos = {};
+  Vec2 maxPos = {};
+
+  Vec2 pos = {};
+  while(uint32_t codepoint = decode_utf8(&text))
   {
-    if(c == '\n')
+    if(codepoint == '\n')
     {
-      pos.y += renderData->fontHeight * textData.fontSize;
-      pos.x = origin.x;
+      pos.y += renderData->fontCache.fontHeight * textData.fontSize;
+      pos.x = 0.0f;
       continue;
     }
 
-    Glyph glyph = renderData->glyphs[c];
+    Glyph glyph = get_glyph(&renderData->fontCache, codepoint, shelfMask);
     Transform transform = {};
-    transform.materialIdx = get_material_idx(textData.material);
+    transform.materialIdx = materialIdx;
     transform.pos.x = pos.x + glyph.offset.x * textData.fontSize;
     transform.pos.y = pos.y - glyph.offset.y * textData.fontSize;
     transform.atlasOffset = glyph.textureCoords;
     transform.spriteSize = glyph.size;
     transform.size = vec_2(glyph.size) * textData.fontSize;
     transform.renderOptions = textData.renderOptions | RENDERING_OPTION_FONT;
-    transform.layer = textData.layer;
 
-    renderData->uiTransforms.add(transform);
+    if(!glyphCount)
+    {
+      minPos = transform.pos;
+      maxPos = transform.pos;
+    }
+    minPos.x = min(minPos.x, transform.pos.x);
+    minPos.y = min(minPos.y, transform.pos.y);
+    maxPos.x = max(maxPos.x, transform.pos.x + transform.size.x);
+    maxPos.y = max(maxPos.y, transform.pos.y + transform.size.y);
+
+    glyphs[glyphCount++] = transform;
 
     // Advance the Glyph
     pos.x += glyph.advance.x * textData.fontSize;
   }
+
+  *bounds = {minPos, maxPos - minPos};
+  return glyphCount;
+}
+
+// Returns -1 if the Cache is full, it is only reset between frames
+int get_text_layout_idx(char* text, TextData textData)
+{
+  uint64_t key = get_text_layout_key(text, textData);
+  int slotIdx = key & (TEXT_LAYOUT_HASH_SLOTS - 1);
+
+  // Linear probing, the table is never more than half full
+  int layoutIdx = -1;
+  while(renderData->textLayoutSlots[slotIdx])
+  {
+    int idx = renderData->textLayoutSlots[slotIdx] - 1;
+    if(renderData->textLayouts[idx].key == key)
+    {
+      layoutIdx = idx;
+      break;
+    }
+
+    slotIdx = (slotIdx + 1) & (TEXT_LAYOUT_HASH_SLOTS - 1);
+  }
+
+  FontCache* fontCache = &renderData->fontCache;
+  if(layoutIdx >= 0 && renderData->textLayouts[layoutIdx].fontGeneration == fontCache->generation)
+  {
+    touch_glyph_shelves(fontCache, renderData->textLayouts[layoutIdx].shelfMask);
+    return layoutIdx;
+  }
+
+  // Either new, or Glyphs were evicted from the Font Atlas since it was laid out
+  int charCount = strlen(text);
+  if((layoutIdx < 0 && renderData->textLayouts.is_full()) ||
+     renderData->textLayoutGlyphs.count + charCount > MAX_TEXT_LAYOUT_GLYPHS)
+  {
+    return -1;
+  }
+
+  TextLayout layout = {};
+  layout.key = key;
+  layout.firstGlyphIdx = renderData->textLayoutGlyphs.count;
+  int droppedGlyphCount = fontCache->droppedGlyphCount;
+  layout.glyphCount = layout_text(text, textData, 
+                                  &renderData->textLayoutGlyphs.elements[layout.firstGlyphIdx],
+                                  &layout.bounds, &layout.shelfMask);
+  // Glyphs that didn't fit into the Atlas are missing, laid out again next frame
+  bool glyphsDropped = fontCache->droppedGlyphCount != droppedGlyphCount;
+  layout.fontGeneration = glyphsDropped? -1: fontCache->generation;
+  renderData->textLayoutGlyphs.count += layout.glyphCount;
+
+  if(layoutIdx >= 0)
+  {
+    // The old Glyphs stay unused in the Pool until it is reset
+    renderData->textLayouts[layoutIdx] = layout;
+  }
+  else
+  {
+    layoutIdx = renderData->textLayouts.add(layout);
+    renderData->textLayoutSlots[slotIdx] = layoutIdx + 1;
+  }
+
+  return layoutIdx;
+}
+
+void draw_ui_text(char* text, Vec2 pos, TextData textData = {})
+{
+  SM_ASSERT(text, "No Text Supplied!");
+  if(!text)
+  {
+    return;
+  }
+
+  Transform* glyphs = nullptr;
+  int glyphCount = 0;
+  Rect bounds = {};
+
+  int layoutIdx = get_text_layout_idx(text, textData);
+  if(layoutIdx >= 0)
+  {
+    TextLayout& layout = renderData->textLayouts[layoutIdx];
+    glyphs = &renderData->textLayoutGlyphs.elements[layout.firstGlyphIdx];
+    glyphCount = layout.glyphCount;
+    bounds = layout.bounds;
+  }
+  else
+  {
+    // The Cache is full for the rest of this frame, lay out the Text anyways
+    glyphs = (Transform*)bump_alloc(renderData->transientStorage, sizeof(Transform) * strlen(text));
+    if(!glyphs)
+    {
+      return;
+    }
+    uint64_t shelfMask = 0;
+    glyphCount = layout_text(text, textData, glyphs, &bounds, &shelfMask);
+  }
+
+  // The Text is culled as a whole
+  bounds.pos.x += pos.x;
+  bounds.pos.y += pos.y;
+  if(!rect_collision(get_camera_rect(renderData->uiCamera), bounds))
+  {
+    return;
+  }
+
+  for(int glyphIdx = 0; glyphIdx < glyphCount; glyphIdx++)
+  {
+    Transform transform = glyphs[glyphIdx];
+    transform.pos.x += pos.x;
+    transform.pos.y += pos.y;
+    transform.layer = textData.layer;
+    add_transform(&renderData->uiTransforms, transform);
+  }
 }
 
 template <typename... Args>
@@ -248,4 +684,116 @@ void draw_format_ui_text(char* format, Vec2 pos, Args... args)
 {
   char* text = format_text(format, args...);
   draw_ui_text(text, pos);
-}
\ No newline at end of file
+}
+
+// #############################################################################
+//                     Render Queue, shared by the Renderers
+// #############################################################################
+uint64_t get_render_key(Transform transform)
+{
+  Material material = renderData->materials[transform.materialIdx];
+  bool isFont = transform.renderOptions & RENDERING_OPTION_FONT;
+  // Glyphs have anti aliased edges
+  bool translucent = material.color.a < 1.0f || isFont;
+
+  unsigned int layerBits;
+  memcpy(&layerBits, &transform.layer, sizeof(float));
+  // Negative floats get all Bits flipped, positive ones only the sign, 
+  // then the Bits sort like the floats
+  layerBits ^= (layerBits & 0x80000000)? 0xFFFFFFFF: 0x80000000;
+  if(!translucent)
+  {
+    layerBits = ~layerBits;
+  }
+
+  uint64_t atlasIdx = isFont? 1: 0;
+
+  uint64_t key = (uint64_t)layerBits << RENDER_KEY_LAYER_SHIFT |
+                 atlasIdx << RENDER_KEY_ATLAS_SHIFT |
+                 (uint64_t)(transform.materialIdx & 0x3FF) << RENDER_KEY_MATERIAL_SHIFT;
+  if(translucent)
+  {
+    key |= RENDER_KEY_TRANSLUCENT_BIT;
+  }
+
+  return key;
+}
+
+// LSD Radix Sort on 8 Bits per pass, stable, so equal Keys keep the submission order.
+// Returns the sorted Array, which is either commands or scratch
+RenderCommand* radix_sort(RenderCommand* commands, RenderCommand* scratch, int count)
+{
+  for(int shift = 0; shift < 64; shift += 8)
+  {
+    int offsets[256] = {};
+    for(int commandIdx = 0; commandIdx < count; commandIdx++)
+    {
+      offsets[(commands[commandIdx].key >> shift) & 0xFF]++;
+    }
+
+    // Most passes only see one value, the unused Bits for example
+    if(offsets[(commands[0].key >> shift) & 0xFF] == count)
+    {
+      continue;
+    }
+
+    int offset = 0;
+    for(int bucketIdx = 0; bucketIdx < 256; bucketIdx++)
+    {
+      int bucketCount = offsets[bucketIdx];
+      offsets[bucketIdx] = offset;
+      offset += bucketCount;
+    }
+
+    for(int commandIdx = 0; commandIdx < count; commandIdx++)
+    {
+      RenderCommand command = commands[commandIdx];
+      scratch[offsets[(command.key >> shift) & 0xFF]++] = command;
+    }
+
+    RenderCommand* tmp = commands;
+    commands = scratch;
+    scratch = tmp;
+  }
+
+  return commands;
+}
+
+RenderQueue build_render_queue(TransformList* list, BumpAllocator* transientStorage)
+{
+  RenderQueue queue = {};
+  int count = list->count;
+  if(!count)
+  {
+    return queue;
+  }
+
+  Transform* transforms = (Transform*)bump_alloc(transientStorage, sizeof(Transform) * count);
+  RenderCommand* commands = (RenderCommand*)bump_alloc(transientStorage, sizeof(RenderCommand) * count);
+  RenderCommand* scratch = (RenderCommand*)bump_alloc(transientStorage, sizeof(RenderCommand) * count);
+  if(!transforms || !commands || !scratch)
+  {
+    return {};
+  }
+
+  int transformIdx = 0;
+  for(TransformChunk* chunk = list->first; chunk; chunk = chunk->next)
+  {
+    memcpy(&transforms[transformIdx], chunk->transforms, sizeof(Transform) * chunk->count);
+    for(int chunkIdx = 0; chunkIdx < chunk->count; chunkIdx++, transformIdx++)
+    {
+      commands[transformIdx] = {get_render_key(transforms[transformIdx]), transformIdx};
+    }
+  }
+
+  queue.transforms = transforms;
+  queue.commands = radix_sort(commands, scratch, count);
+  queue.count = count;
+  while(queue.opaqueCount < count && 
+        !(queue.commands[queue.opaqueCount].key & RENDER_KEY_TRANSLUCENT_BIT))
+  {
+    queue.opaqueCount++;
+  }
+
+  return queue;
+}
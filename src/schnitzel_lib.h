@@ -14,6 +14,9 @@
 // Obvious right?
 #include <math.h>
 
+// Fixed size integers, used for the Bitboards
+#include <stdint.h>
+
 // #############################################################################
 //                           Constants
 // #############################################################################
@@ -346,6 +349,21 @@ bool copy_file(const char* fileName, const char* outputName, BumpAllocator* bump
   return false;
 }
 
+// #############################################################################
+//                           Hashing
+// #############################################################################
+// FNV-1a, used to compare State dumps and to key caches, not for security
+uint64_t hash_bytes(const char* data, long long size, uint64_t hash = 14695981039346656037ull)
+{
+  for(long long byteIdx = 0; byteIdx < size; byteIdx++)
+  {
+    hash ^= (unsigned char)data[byteIdx];
+    hash *= 1099511628211ull;
+  }
+
+  return hash;
+}
+
 // #############################################################################
 //                           Math stuff
 // #############################################################################
@@ -467,6 +485,16 @@ struct IVec2
   {
     return {x / scalar, y / scalar};
   }
+
+  bool operator==(IVec2 other)
+  {
+    return x == other.x && y == other.y;
+  }
+
+  bool operator!=(IVec2 other)
+  {
+    return !(*this == other);
+  }
 };
 
 Vec2 vec_2(IVec2 v)
@@ -613,6 +641,14 @@ bool rect_collision(IRect a, IRect b)
          a.pos.y + a.size.y > b.pos.y;    // Collision on Top of a and Bottom of b
 }
 
+bool rect_collision(Rect a, Rect b)
+{
+  return a.pos.x < b.pos.x  + b.size.x &&
+         a.pos.x + a.size.x > b.pos.x  &&
+         a.pos.y < b.pos.y  + b.size.y &&
+         a.pos.y + a.size.y > b.pos.y;
+}
+
 
 
 // #############################################################################
@@ -21,6 +21,9 @@ int RENDERING_OPTION_FLIP_X = BIT(0);
 int RENDERING_OPTION_FLIP_Y = BIT(1);
 int RENDERING_OPTION_FONT = BIT(2);
 
+// Tile Types the Tile Map can hold, see tilemap.frag
+const int MAX_TILE_TYPES = 32;
+
 // #############################################################################
 //                           Rendering Structs
 // #############################################################################
@@ -36,6 +39,101 @@ struct Transform
   int padding;
 };
 
+// Alternate GPU format, selected with PACKED_TRANSFORMS at build time
+// posXY:       x, y as signed 12.4 fixed point, 16 Bits each
+// sizeXY:      x, y as unsigned 12.4 fixed point, 16 Bits each
+// atlas:       atlasOffset.x 12 Bits | atlasOffset.y 12 Bits | spriteSize.x 8 Bits
+// options:     spriteSize.y 8 Bits | renderOptions 3 Bits | materialIdx 10 Bits | layer * 1000 11 Bits
+struct PackedTransform
+{
+  int posXY;
+  int sizeXY;
+  int atlas;
+  int options;
+};
+
+#ifdef ENGINE
+PackedTransform pack_transform(Transform transform)
+{
+  int posX = (int)roundf(transform.pos.x * 16.0f);
+  int posY = (int)roundf(transform.pos.y * 16.0f);
+  int sizeX = (int)roundf(transform.size.x * 16.0f);
+  int sizeY = (int)roundf(transform.size.y * 16.0f);
+  int layer = (int)roundf(transform.layer * 1000.0f);
+
+  // Anything outside the Bits of its Field would wrap around
+  SM_ASSERT(posX >= -0x8000 && posX <= 0x7FFF && posY >= -0x8000 && posY <= 0x7FFF,
+            "Transform pos %.2f, %.2f doesn't fit 12.4 Bits", transform.pos.x, transform.pos.y);
+  SM_ASSERT(sizeX >= 0 && sizeX <= 0xFFFF && sizeY >= 0 && sizeY <= 0xFFFF,
+            "Transform size %.2f, %.2f doesn't fit 12.4 Bits", transform.size.x, transform.size.y);
+  SM_ASSERT(transform.atlasOffset.x >= 0 && transform.atlasOffset.x <= 0xFFF &&
+            transform.atlasOffset.y >= 0 && transform.atlasOffset.y <= 0xFFF,
+            "Transform atlasOffset %d, %d doesn't fit 12 Bits", 
+            transform.atlasOffset.x, transform.atlasOffset.y);
+  SM_ASSERT(transform.spriteSize.x >= 0 && transform.spriteSize.x <= 0xFF &&
+            transform.spriteSize.y >= 0 && transform.spriteSize.y <= 0xFF,
+            "Transform spriteSize %d, %d doesn't fit 8 Bits", 
+            transform.spriteSize.x, transform.spriteSize.y);
+  SM_ASSERT(transform.renderOptions >= 0 && transform.renderOptions <= 0x7,
+            "Transform renderOptions %d don't fit 3 Bits", transform.renderOptions);
+  SM_ASSERT(transform.materialIdx >= 0 && transform.materialIdx <= 0x3FF,
+            "Transform materialIdx %d doesn't fit 10 Bits", transform.materialIdx);
+  SM_ASSERT(layer >= 0 && layer <= 0x7FF,
+            "Transform layer %.4f doesn't fit 11 Bits", transform.layer);
+
+  PackedTransform packedTransform;
+  packedTransform.posXY = (posX & 0xFFFF) | ((posY & 0xFFFF) << 16);
+  packedTransform.sizeXY = (sizeX & 0xFFFF) | ((sizeY & 0xFFFF) << 16);
+  packedTransform.atlas = (transform.atlasOffset.x & 0xFFF) | 
+                          ((transform.atlasOffset.y & 0xFFF) << 12) | 
+                          ((transform.spriteSize.x & 0xFF) << 24);
+  packedTransform.options = (transform.spriteSize.y & 0xFF) | 
+                            ((transform.renderOptions & 0x7) << 8) | 
+                            ((transform.materialIdx & 0x3FF) << 11) | 
+                            ((layer & 0x7FF) << 21);
+  return packedTransform;
+}
+
+// Same as the Shader version below, schnitzel_headless --check-packing
+// compares it to the Transforms that were packed
+Transform unpack_transform(PackedTransform packedTransform)
+{
+  Transform transform = {};
+  // Shifting left first sign extends the lower half
+  transform.pos = {(float)((packedTransform.posXY << 16) >> 16) / 16.0f, 
+                   (float)(packedTransform.posXY >> 16) / 16.0f};
+  transform.size = {(float)(packedTransform.sizeXY & 0xFFFF) / 16.0f, 
+                    (float)((packedTransform.sizeXY >> 16) & 0xFFFF) / 16.0f};
+  transform.atlasOffset = {packedTransform.atlas & 0xFFF, 
+                           (packedTransform.atlas >> 12) & 0xFFF};
+  transform.spriteSize = {(packedTransform.atlas >> 24) & 0xFF, 
+                          packedTransform.options & 0xFF};
+  transform.renderOptions = (packedTransform.options >> 8) & 0x7;
+  transform.materialIdx = (packedTransform.options >> 11) & 0x3FF;
+  transform.layer = (float)((packedTransform.options >> 21) & 0x7FF) / 1000.0f;
+  return transform;
+}
+#else
+Transform unpack_transform(PackedTransform packedTransform)
+{
+  Transform transform;
+  // Shifting left first sign extends the lower half
+  transform.pos = vec2((packedTransform.posXY << 16) >> 16, 
+                       packedTransform.posXY >> 16) / 16.0;
+  transform.size = vec2(packedTransform.sizeXY & 0xFFFF, 
+                        (packedTransform.sizeXY >> 16) & 0xFFFF) / 16.0;
+  transform.atlasOffset = ivec2(packedTransform.atlas & 0xFFF, 
+                                (packedTransform.atlas >> 12) & 0xFFF);
+  transform.spriteSize = ivec2((packedTransform.atlas >> 24) & 0xFF, 
+                               packedTransform.options & 0xFF);
+  transform.renderOptions = (packedTransform.options >> 8) & 0x7;
+  transform.materialIdx = (packedTransform.options >> 11) & 0x3FF;
+  transform.layer = float((packedTransform.options >> 21) & 0x7FF) / 1000.0;
+  transform.padding = 0;
+  return transform;
+}
+#endif
+
 struct Material
 {
 	// Operator inside the Engine to compare materials
@@ -0,0 +1,18 @@
+#pragma once
+
+// Generated by asset_baker.cpp from assets/sprites/sprites.txt, don't edit
+enum SpriteID
+{
+  SPRITE_WHITE,
+  SPRITE_DICE,
+  SPRITE_CELESTE,
+  SPRITE_CELESTE_RUN,
+  SPRITE_CELESTE_JUMP,
+  SPRITE_SOLID_01,
+  SPRITE_SOLID_02,
+  SPRITE_BUTTON_PLAY,
+  SPRITE_BUTTON_SAVE,
+  SPRITE_TILESET,
+
+  SPRITE_COUNT
+};
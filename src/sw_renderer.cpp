@@ -0,0 +1,564 @@
+#include "render_interface.h"
+
+// To Load the Texture Atlas, written by asset_baker.cpp
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+// The Rows of the Framebuffer are split across Threads, Pixels are shaded with SSE2
+#include <thread>
+#include <emmintrin.h>
+
+// #############################################################################
+//                           Software Renderer Constants
+// #############################################################################
+constexpr int SW_MAX_THREADS = 16;
+
+// Linear to sRGB is looked up, fine enough to be off by one at most
+constexpr int SRGB_ENCODE_TABLE_SIZE = 16384;
+
+// Same as glClearColor() in gl_render(), linear, encoded to sRGB when cleared
+constexpr Vec4 SW_CLEAR_COLOR = {119.0f / 255.0f, 33.0f / 255.0f, 111.0f / 255.0f, 1.0f};
+
+// #############################################################################
+//                           Software Renderer Structs
+// #############################################################################
+// One Draw call of gl_render(), the Transforms are in the order they are drawn in
+struct SWDraw
+{
+  Transform* transforms;
+  int count;
+  bool translucent;
+  Mat4 orthoProjection;
+};
+
+struct SWContext
+{
+  IVec2 screenSize;
+  // RGBA, sRGB encoded Color and linear Alpha, like the GL_SRGB8_ALPHA8 Framebuffer,
+  // the Render Target scaled up, see sw_present_render_target()
+  unsigned int* colorBuffer;
+
+  // Drawn into by sw_render(), allocated every Frame from the transient Storage
+  IVec2 targetSize;
+  unsigned int* targetColorBuffer;
+  // Cleared to 0, GL_GREATER passes, like in gl_init()
+  float* depthBuffer;
+
+  // Decoded to linear once, that is what sampling the GL_SRGB8_ALPHA8 Texture returns
+  IVec2 textureSize;
+  Vec4* texture;
+
+  float srgbDecode[256];
+  unsigned char srgbEncode[SRGB_ENCODE_TABLE_SIZE];
+
+  int threadCount;
+};
+
+// #############################################################################
+//                           Software Renderer Globals
+// #############################################################################
+static SWContext swContext;
+
+// #############################################################################
+//                           Software Renderer Functions
+// #############################################################################
+float srgb_to_linear(float c)
+{
+  return c <= 0.04045f? c / 12.92f: powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linear_to_srgb(float c)
+{
+  return c <= 0.0031308f? c * 12.92f: 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+}
+
+// Expects the Color to be clamped to 0 - 1
+unsigned int sw_encode_color(__m128 color)
+{
+  __m128i encodeIdx = _mm_cvtps_epi32(_mm_mul_ps(color, _mm_set1_ps(SRGB_ENCODE_TABLE_SIZE - 1)));
+  __m128i alpha = _mm_cvtps_epi32(_mm_mul_ps(color, _mm_set1_ps(255.0f)));
+
+  int idx[4];
+  int a[4];
+  _mm_storeu_si128((__m128i*)idx, encodeIdx);
+  _mm_storeu_si128((__m128i*)a, alpha);
+
+  return (unsigned int)swContext.srgbEncode[idx[0]] |
+         (unsigned int)swContext.srgbEncode[idx[1]] << 8 |
+         (unsigned int)swContext.srgbEncode[idx[2]] << 16 |
+         (unsigned int)a[3] << 24;
+}
+
+__m128 sw_decode_color(unsigned int color)
+{
+  return _mm_setr_ps(swContext.srgbDecode[color & 0xFF],
+                     swContext.srgbDecode[(color >> 8) & 0xFF],
+                     swContext.srgbDecode[(color >> 16) & 0xFF],
+                     (float)(color >> 24) / 255.0f);
+}
+
+bool sw_init(IVec2 screenSize, BumpAllocator* persistentStorage)
+{
+  int pixelCount = screenSize.x * screenSize.y;
+  swContext.screenSize = screenSize;
+  swContext.colorBuffer =
+    (unsigned int*)bump_alloc(persistentStorage, sizeof(unsigned int) * pixelCount);
+  if(!swContext.colorBuffer)
+  {
+    SM_ASSERT(false, "Failed to allocate the Framebuffer");
+    return false;
+  }
+
+  for(int i = 0; i < 256; i++)
+  {
+    swContext.srgbDecode[i] = srgb_to_linear((float)i / 255.0f);
+  }
+  for(int i = 0; i < SRGB_ENCODE_TABLE_SIZE; i++)
+  {
+    float c = linear_to_srgb((float)i / (float)(SRGB_ENCODE_TABLE_SIZE - 1));
+    swContext.srgbEncode[i] = (unsigned char)(c * 255.0f + 0.5f);
+  }
+
+  // Texture Loading using STBI
+  {
+    int width, height, channels;
+    unsigned char* data = stbi_load(TEXTURE_PATH, &width, &height, &channels, 4);
+    if(!data)
+    {
+      SM_ASSERT(false, "Failed to load texture");
+      return false;
+    }
+
+    swContext.textureSize = {width, height};
+    swContext.texture = (Vec4*)bump_alloc(persistentStorage, sizeof(Vec4) * width * height);
+    if(!swContext.texture)
+    {
+      SM_ASSERT(false, "Failed to allocate the Texture");
+      stbi_image_free(data);
+      return false;
+    }
+
+    for(int i = 0; i < width * height; i++)
+    {
+      swContext.texture[i] =
+      {
+        swContext.srgbDecode[data[i * 4 + 0]],
+        swContext.srgbDecode[data[i * 4 + 1]],
+        swContext.srgbDecode[data[i * 4 + 2]],
+        (float)data[i * 4 + 3] / 255.0f
+      };
+    }
+
+    stbi_image_free(data);
+  }
+
+  // Glyphs are rasterized with FreeType when Texts first use them, the
+  // baked Font needs the Platform Layer to be mapped, see load_font()
+  {
+    FontCache* fontCache = &renderData->fontCache;
+    strncpy(fontCache->fontPath, FONT_PATH, sizeof(fontCache->fontPath) - 1);
+    fontCache->fontSize = FONT_SIZE;
+  }
+
+  swContext.threadCount =
+    min(max((int)std::thread::hardware_concurrency(), 1), SW_MAX_THREADS);
+
+  return true;
+}
+
+// Same as quad.vert and quad.frag, only for the Rows from firstRow to lastRow - 1.
+// Transforms are axis aligned, so the two Triangles cover the Pixels whose
+// center is inside the Rect, the Texture Coordinates are linear across it
+void sw_draw_transform(Transform transform, Mat4 orthoProjection, bool translucent,
+                       int firstRow, int lastRow)
+{
+  // Outside the Depth Range, clipped
+  if(transform.layer < -1.0f || transform.layer > 1.0f)
+  {
+    return;
+  }
+
+  // orthoProjection * vec4(pos, layer, 1.0), then to Pixels, Row 0 is the top
+  Vec2 screenSize = vec_2(swContext.targetSize);
+  Vec2 corners[2] = 
+  {
+    transform.pos, 
+    {transform.pos.x + transform.size.x, transform.pos.y + transform.size.y}
+  };
+  Vec2 screenCorners[2];
+  for(int cornerIdx = 0; cornerIdx < 2; cornerIdx++)
+  {
+    Vec2 corner = corners[cornerIdx];
+    float ndcX = orthoProjection.ax * corner.x + orthoProjection.ay * corner.y + orthoProjection.aw;
+    float ndcY = orthoProjection.bx * corner.x + orthoProjection.by * corner.y + orthoProjection.bw;
+    screenCorners[cornerIdx] = {(ndcX + 1.0f) * 0.5f * screenSize.x,
+                                (1.0f - ndcY) * 0.5f * screenSize.y};
+  }
+
+  int left = transform.atlasOffset.x;
+  int top = transform.atlasOffset.y;
+  int right = transform.atlasOffset.x + transform.spriteSize.x;
+  int bottom = transform.atlasOffset.y + transform.spriteSize.y;
+
+  if(transform.renderOptions & RENDERING_OPTION_FLIP_X)
+  {
+    int tmp = left;
+    left = right;
+    right = tmp;
+  }
+
+  if(transform.renderOptions & RENDERING_OPTION_FLIP_Y)
+  {
+    int tmp = top;
+    top = bottom;
+    bottom = tmp;
+  }
+
+  Vec2 screenDelta = screenCorners[1] - screenCorners[0];
+  if(screenDelta.x == 0.0f || screenDelta.y == 0.0f)
+  {
+    return;
+  }
+  Vec2 textureScale = {(float)(right - left) / screenDelta.x,
+                       (float)(bottom - top) / screenDelta.y};
+
+  // Pixels with their center from the min edge up to, but not on the max edge
+  float minX = min(screenCorners[0].x, screenCorners[1].x);
+  float maxX = max(screenCorners[0].x, screenCorners[1].x);
+  float minY = min(screenCorners[0].y, screenCorners[1].y);
+  float maxY = max(screenCorners[0].y, screenCorners[1].y);
+  int startX = max((int)ceilf(minX - 0.5f), 0);
+  int endX = min((int)ceilf(maxX - 0.5f), swContext.targetSize.x);
+  int startY = max((int)ceilf(minY - 0.5f), firstRow);
+  int endY = min((int)ceilf(maxY - 0.5f), lastRow);
+  if(startX >= endX || startY >= endY)
+  {
+    return;
+  }
+
+  bool isFont = transform.renderOptions & RENDERING_OPTION_FONT;
+  IVec2 textureSize = isFont? IVec2{FONT_ATLAS_SIZE, FONT_ATLAS_SIZE}: swContext.textureSize;
+  unsigned char* fontAtlas = renderData->fontCache.atlas;
+  Vec4 materialColor = renderData->materials[transform.materialIdx].color;
+  __m128 material = _mm_loadu_ps(&materialColor.x);
+  __m128 zero = _mm_setzero_ps();
+  __m128 one = _mm_set1_ps(1.0f);
+  // Window Depth, the Depth Range is 0 - 1
+  float depth = transform.layer * 0.5f + 0.5f;
+  __m128 depth4 = _mm_set1_ps(depth);
+
+  // Texture Coordinate u of 4 Pixels at once, from the one of the first Pixel
+  __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+  __m128 uStep = _mm_set1_ps(textureScale.x);
+  float firstU = (float)left + ((float)startX + 0.5f - screenCorners[0].x) * textureScale.x;
+
+  for(int y = startY; y < endY; y++)
+  {
+    float v = (float)top + ((float)y + 0.5f - screenCorners[0].y) * textureScale.y;
+    int textureY = (int)v;
+    if(v < 0.0f || textureY >= textureSize.y)
+    {
+      continue;
+    }
+
+    unsigned int* colorRow = &swContext.targetColorBuffer[y * swContext.targetSize.x];
+    float* depthRow = &swContext.depthBuffer[y * swContext.targetSize.x];
+
+    for(int x = startX; x < endX; x += 4)
+    {
+      int laneCount = min(endX - x, 4);
+      __m128 u = _mm_add_ps(_mm_set1_ps(firstU),
+                            _mm_mul_ps(_mm_add_ps(_mm_set1_ps((float)(x - startX)), laneOffsets), uStep));
+      int textureX[4];
+      float us[4];
+      _mm_storeu_si128((__m128i*)textureX, _mm_cvttps_epi32(u));
+      _mm_storeu_ps(us, u);
+
+      // GL_GREATER
+      float depths[4] = {};
+      memcpy(depths, &depthRow[x], sizeof(float) * laneCount);
+      int depthMask = _mm_movemask_ps(_mm_cmpgt_ps(depth4, _mm_loadu_ps(depths)));
+
+      for(int lane = 0; lane < laneCount; lane++)
+      {
+        if(!(depthMask & (1 << lane)) || us[lane] < 0.0f || textureX[lane] >= textureSize.x)
+        {
+          continue;
+        }
+
+        __m128 color;
+        if(isFont)
+        {
+          unsigned char r = fontAtlas[textureY * FONT_ATLAS_SIZE + textureX[lane]];
+          if(!r)
+          {
+            continue; // discard
+          }
+          color = _mm_mul_ps(_mm_set1_ps((float)r / 255.0f), material);
+        }
+        else
+        {
+          Vec4 texel = swContext.texture[textureY * textureSize.x + textureX[lane]];
+          if(texel.a == 0.0f)
+          {
+            continue; // discard
+          }
+          color = _mm_mul_ps(_mm_loadu_ps(&texel.x), material);
+        }
+
+        // The Framebuffer is normalized, so Colors are clamped before blending
+        color = _mm_min_ps(_mm_max_ps(color, zero), one);
+
+        int pixelX = x + lane;
+        if(translucent)
+        {
+          // GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, blended in linear space
+          __m128 srcAlpha = _mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3));
+          __m128 dst = sw_decode_color(colorRow[pixelX]);
+          color = _mm_add_ps(_mm_mul_ps(color, srcAlpha),
+                             _mm_mul_ps(dst, _mm_sub_ps(one, srcAlpha)));
+        }
+        else
+        {
+          depthRow[pixelX] = depth;
+        }
+
+        colorRow[pixelX] = sw_encode_color(color);
+      }
+    }
+  }
+}
+
+void sw_draw_rows(SWDraw* draws, int drawCount, int firstRow, int lastRow)
+{
+  __m128 clearColor = _mm_loadu_ps(&SW_CLEAR_COLOR.x);
+  unsigned int clearValue = sw_encode_color(clearColor);
+  int firstPixel = firstRow * swContext.targetSize.x;
+  int pixelCount = (lastRow - firstRow) * swContext.targetSize.x;
+  for(int pixelIdx = firstPixel; pixelIdx < firstPixel + pixelCount; pixelIdx++)
+  {
+    swContext.targetColorBuffer[pixelIdx] = clearValue;
+  }
+  memset(&swContext.depthBuffer[firstPixel], 0, sizeof(float) * pixelCount);
+
+  for(int drawIdx = 0; drawIdx < drawCount; drawIdx++)
+  {
+    SWDraw draw = draws[drawIdx];
+    for(int transformIdx = 0; transformIdx < draw.count; transformIdx++)
+    {
+      sw_draw_transform(draw.transforms[transformIdx], draw.orthoProjection, draw.translucent,
+                        firstRow, lastRow);
+    }
+  }
+}
+
+// The Transforms in the order they are drawn in, gl_render() writes them into the Transform Ring
+Transform* sw_gather_render_queue(RenderQueue queue, bool packTransforms, 
+                                  BumpAllocator* transientStorage)
+{
+  Transform* transforms = (Transform*)bump_alloc(transientStorage, sizeof(Transform) * queue.count);
+  for(int commandIdx = 0; transforms && commandIdx < queue.count; commandIdx++)
+  {
+    Transform transform = queue.transforms[queue.commands[commandIdx].transformIdx];
+    // Like gl_write_render_queue() and quad.vert in PACKED_TRANSFORMS builds
+    transforms[commandIdx] = 
+      packTransforms? unpack_transform(pack_transform(transform)): transform;
+  }
+
+  return transforms;
+}
+
+// One Transform per visible Tile that isn't empty, the Pixels tilemap.frag would draw
+Transform* sw_gather_tile_map(IRect visibleTiles, int* tileCount, BumpAllocator* transientStorage)
+{
+  *tileCount = 0;
+  int maxTileCount = visibleTiles.size.x * visibleTiles.size.y;
+  Transform* transforms = (Transform*)bump_alloc(transientStorage, sizeof(Transform) * maxTileCount);
+  if(!maxTileCount || !transforms)
+  {
+    return nullptr;
+  }
+
+  int tileSize = renderData->tileSize;
+  for(int y = 0; y < visibleTiles.size.y; y++)
+  {
+    for(int x = 0; x < visibleTiles.size.x; x++)
+    {
+      IVec2 tilePos = {visibleTiles.pos.x + x, visibleTiles.pos.y + y};
+      int tileType = renderData->tileMap[tilePos.y * renderData->tileMapSize.x + tilePos.x];
+
+      if(!tileType)
+      {
+        continue;
+      }
+
+      Transform& transform = transforms[(*tileCount)++];
+      transform = {};
+      transform.pos = {(float)(tilePos.x * tileSize), (float)(tilePos.y * tileSize)};
+      transform.size = {(float)tileSize, (float)tileSize};
+      transform.atlasOffset = renderData->tileAtlasOffsets[tileType - 1];
+      transform.spriteSize = {tileSize, tileSize};
+      transform.materialIdx = renderData->tileMaterialIdx;
+      transform.layer = renderData->tileLayer;
+    }
+  }
+
+  return transforms;
+}
+
+Mat4 sw_get_projection(OrthographicCamera2D camera)
+{
+  return orthographic_projection(camera.position.x - camera.dimensions.x / 2.0f,
+                                 camera.position.x + camera.dimensions.x / 2.0f,
+                                 camera.position.y - camera.dimensions.y / 2.0f,
+                                 camera.position.y + camera.dimensions.y / 2.0f);
+}
+
+// Like the Blit in gl_present_render_target(), Nearest for integer Scales,
+// smaller Screens, which GL filters linearly, are only point sampled here
+void sw_present_render_target()
+{
+  IVec2 screenSize = swContext.screenSize;
+  IVec2 targetSize = swContext.targetSize;
+  IRect viewport = get_render_target_viewport();
+  unsigned int black = 0xFF000000;
+
+  for(int y = 0; y < screenSize.y; y++)
+  {
+    unsigned int* colorRow = &swContext.colorBuffer[y * screenSize.x];
+    int targetY = (y - viewport.pos.y) * targetSize.y / viewport.size.y;
+    if(y < viewport.pos.y || targetY >= targetSize.y)
+    {
+      for(int x = 0; x < screenSize.x; x++)
+      {
+        colorRow[x] = black;
+      }
+      continue;
+    }
+
+    unsigned int* targetRow = &swContext.targetColorBuffer[targetY * targetSize.x];
+    for(int x = 0; x < screenSize.x; x++)
+    {
+      int targetX = (x - viewport.pos.x) * targetSize.x / viewport.size.x;
+      bool inside = x >= viewport.pos.x && targetX < targetSize.x;
+      colorRow[x] = inside? targetRow[targetX] : black;
+    }
+  }
+}
+
+// Draws the same Passes as gl_render(), but doesn't reset the Frame afterwards,
+// the caller does that, see reset_frame() in headless_main.cpp. packTransforms
+// draws the Transforms the way PACKED_TRANSFORMS builds get them on the GPU
+void sw_render(BumpAllocator* transientStorage, bool packTransforms = false)
+{
+  renderData->instanceCount = 0;
+  renderData->drawCallCount = 0;
+
+  // Same Resolution gl_render() draws at
+  swContext.targetSize = get_render_target_size();
+  int targetPixelCount = swContext.targetSize.x * swContext.targetSize.y;
+  swContext.targetColorBuffer =
+    (unsigned int*)bump_alloc(transientStorage, sizeof(unsigned int) * targetPixelCount);
+  swContext.depthBuffer = (float*)bump_alloc(transientStorage, sizeof(float) * targetPixelCount);
+  if(!swContext.targetColorBuffer || !swContext.depthBuffer)
+  {
+    return;
+  }
+
+  // Game and UI Pass, the opaque Transforms, the Tile Map and the translucent Transforms
+  int maxDrawCount = 5;
+  SWDraw* draws = (SWDraw*)bump_alloc(transientStorage, sizeof(SWDraw) * maxDrawCount);
+  if(!draws)
+  {
+    return;
+  }
+  int drawCount = 0;
+
+  // Game Pass
+  {
+    Mat4 orthoProjection = sw_get_projection(renderData->gameCamera);
+    RenderQueue queue = build_render_queue(&renderData->transforms, transientStorage);
+    Transform* transforms = sw_gather_render_queue(queue, packTransforms, transientStorage);
+
+    draws[drawCount++] = {transforms, queue.opaqueCount, false, orthoProjection};
+
+    // Tile Layer, the Tile Map gl_render() draws in one go
+    {
+      IRect visibleTiles = get_visible_tiles(renderData->gameCamera);
+      int tileCount = 0;
+      Transform* tileTransforms = sw_gather_tile_map(visibleTiles, &tileCount, transientStorage);
+      draws[drawCount++] = {tileTransforms, tileCount, false, orthoProjection};
+    }
+
+    draws[drawCount++] = {&transforms[queue.opaqueCount], queue.count - queue.opaqueCount,
+                          true, orthoProjection};
+  }
+
+  // UI Pass
+  {
+    Mat4 orthoProjection = sw_get_projection(renderData->uiCamera);
+    RenderQueue queue = build_render_queue(&renderData->uiTransforms, transientStorage);
+    Transform* transforms = sw_gather_render_queue(queue, packTransforms, transientStorage);
+
+    draws[drawCount++] = {transforms, queue.opaqueCount, false, orthoProjection};
+    draws[drawCount++] = {&transforms[queue.opaqueCount], queue.count - queue.opaqueCount,
+                          true, orthoProjection};
+  }
+
+  for(int drawIdx = 0; drawIdx < drawCount; drawIdx++)
+  {
+    if(draws[drawIdx].count)
+    {
+      renderData->instanceCount += draws[drawIdx].count;
+      renderData->drawCallCount++;
+    }
+  }
+
+  // Each Thread draws everything into its own Rows, so they never touch the same Pixels
+  std::thread threads[SW_MAX_THREADS];
+  int rowCount = swContext.targetSize.y;
+  for(int threadIdx = 1; threadIdx < swContext.threadCount; threadIdx++)
+  {
+    threads[threadIdx] = std::thread(sw_draw_rows, draws, drawCount,
+                                     rowCount * threadIdx / swContext.threadCount,
+                                     rowCount * (threadIdx + 1) / swContext.threadCount);
+  }
+  sw_draw_rows(draws, drawCount, 0, rowCount / swContext.threadCount);
+  for(int threadIdx = 1; threadIdx < swContext.threadCount; threadIdx++)
+  {
+    threads[threadIdx].join();
+  }
+  sw_present_render_target();
+}
+
+uint64_t sw_get_frame_hash()
+{
+  int pixelCount = swContext.screenSize.x * swContext.screenSize.y;
+  return hash_bytes((char*)swContext.colorBuffer, pixelCount * 4);
+}
+
+// Binary PPM, the Color of the Framebuffer without Alpha
+void sw_write_frame(const char* filePath, BumpAllocator* transientStorage)
+{
+  char header[32];
+  int headerSize = sprintf(header, "P6 %d %d 255\n", swContext.screenSize.x, swContext.screenSize.y);
+  int pixelCount = swContext.screenSize.x * swContext.screenSize.y;
+
+  char* buffer = bump_alloc(transientStorage, headerSize + pixelCount * 3);
+  if(!buffer)
+  {
+    return;
+  }
+
+  memcpy(buffer, header, headerSize);
+  char* pixels = buffer + headerSize;
+  for(int pixelIdx = 0; pixelIdx < pixelCount; pixelIdx++)
+  {
+    unsigned int color = swContext.colorBuffer[pixelIdx];
+    pixels[pixelIdx * 3 + 0] = color & 0xFF;
+    pixels[pixelIdx * 3 + 1] = (color >> 8) & 0xFF;
+    pixels[pixelIdx * 3 + 2] = (color >> 16) & 0xFF;
+  }
+
+  write_file(filePath, buffer, headerSize + pixelCount * 3);
+}
@@ -22,8 +22,8 @@ void init_strings()
   Strings[(int)LOCALIZATION_ENG + (int)STRING_CELESTE_CLONE] = "Celeste Clone";
   Strings[(int)LOCALIZATION_ENG + (int)STRING_MADE_IN_CPP] = "Made in C++";
 
-  // German Translation, ö, Ö, ä, Ä, don't work like this!!!! I myself have no solution YET!
-  // But we will have a solution in the future
+  // German Translation, Texts are UTF-8, so ö, Ö, ä, Ä work, their Glyphs
+  // are rasterized the first time they are drawn, see font.h
   Strings[(int)LOCALIZATION_GER * STRING_COUNT + (int)STRING_CELESTE_CLONE] = "Celeste Klon";
   Strings[(int)LOCALIZATION_GER * STRING_COUNT + (int)STRING_MADE_IN_CPP] = "Geschrieben in C++";
 }
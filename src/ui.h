@@ -9,7 +9,9 @@
 //                           UI Constants
 // #############################################################################
 constexpr int MAX_UI_ELEMENTS = 100;
+constexpr int MAX_UI_TEXTS = 1000;
 constexpr int MAX_TEXT_CHARS = 256;
+constexpr int UI_TEXT_BUFFER_SIZE = KB(32);
 
 // #############################################################################
 //                           UI Structs
@@ -30,8 +32,7 @@ struct UIElement
 
 struct UIText
 {
-  int charCount;
-  char text[MAX_TEXT_CHARS];
+  int textOffset; // Into UIState::textBuffer
   Vec2 pos;
   TextData textData;
 };
@@ -44,8 +45,12 @@ struct UIState
 
   int layer = 0;
 
-  Array<UIText, 100> uiTexts;
+  Array<UIText, MAX_UI_TEXTS> uiTexts;
   Array<UIElement, MAX_UI_ELEMENTS> uiElements;
+
+  // Null terminated Texts of this update, packed back to back
+  int textBufferUsed;
+  char textBuffer[UI_TEXT_BUFFER_SIZE];
 };
 
 // #############################################################################
@@ -66,6 +71,7 @@ void update_ui()
 
   uiState->uiElements.clear();
   uiState->uiTexts.clear();
+  uiState->textBufferUsed = 0;
   uiState->hotLastFrame = uiState->hotThisFrame;
   uiState->hotThisFrame = {};
 }
@@ -153,11 +159,18 @@ bool do_button(SpriteID spriteID, IVec2 pos, int ID, DrawData drawData = {})
 void do_ui_text(const char* text, Vec2 pos, TextData textData = {})
 {
   SM_ASSERT(text, "No Text supplied!");
-  SM_ASSERT(strlen(text) < MAX_TEXT_CHARS, "Text too long!");
+  int charCount = strlen(text);
+  SM_ASSERT(charCount < MAX_TEXT_CHARS, "Text too long!");
+  if(uiState->textBufferUsed + charCount + 1 > UI_TEXT_BUFFER_SIZE)
+  {
+    SM_ASSERT(false, "UI Text Buffer full!");
+    return;
+  }
 
   UIText uiText = {};
-  memcpy(uiText.text, text, strlen(text));
-  uiText.charCount = strlen(text);
+  uiText.textOffset = uiState->textBufferUsed;
+  memcpy(&uiState->textBuffer[uiText.textOffset], text, charCount + 1);
+  uiState->textBufferUsed += charCount + 1;
   uiText.pos = pos;
   uiText.textData = textData;
 
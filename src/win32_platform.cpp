@@ -658,4 +658,41 @@ void platform_update_audio(float dt)
 void platform_sleep(unsigned int ms)
 {
   Sleep(ms);
+}
+
+char* platform_map_file(const char* filePath, long long* fileSize)
+{
+  *fileSize = 0;
+  HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, 
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(file == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+
+  char* data = nullptr;
+  LARGE_INTEGER size = {};
+  if(GetFileSizeEx(file, &size) && size.QuadPart > 0)
+  {
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping)
+    {
+      data = (char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      if(data)
+      {
+        *fileSize = size.QuadPart;
+      }
+
+      // The View stays valid after closing the Handles
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+
+  return data;
+}
+
+void platform_unmap_file(char* data, long long fileSize)
+{
+  UnmapViewOfFile(data);
 }
\ No newline at end of file